@@ -0,0 +1,224 @@
+#define _DEFAULT_SOURCE
+#define _FILE_OFFSET_BITS 64 // Offsets como 0xFF200000 precisam caber em off_t no arquivo substituto
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "de1soc.h"
+
+static int hw_fd = -1;
+static HwBackend hw_current_backend = HW_BACKEND_MMIO;
+
+int hw_open(HwBackend backend, const char *path) {
+    hw_current_backend = backend;
+    if (backend == HW_BACKEND_MMIO) {
+        hw_fd = open(HW_MEM_DEVICE, O_RDWR | O_SYNC);
+        if (hw_fd == -1) { perror("Erro ao abrir " HW_MEM_DEVICE); return -1; }
+    } else {
+        hw_fd = open(path, O_RDWR | O_CREAT, 0666);
+        if (hw_fd == -1) { perror("Erro ao abrir o arquivo substituto"); return -1; }
+    }
+    return 0;
+}
+
+volatile void *hw_map(uint32_t phys_base, size_t size) {
+    if (hw_fd == -1) return NULL;
+
+    if (hw_current_backend == HW_BACKEND_FILE) {
+        // O arquivo é esparso: só as janelas realmente usadas ocupam espaço.
+        struct stat st;
+        off_t end = (off_t)phys_base + (off_t)size;
+        if (fstat(hw_fd, &st) == -1) { perror("Erro no fstat"); return NULL; }
+        if (st.st_size < end && ftruncate(hw_fd, end) == -1) { perror("Erro ao estender o arquivo substituto"); return NULL; }
+    }
+
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, hw_fd, (off_t)phys_base);
+    if (map == MAP_FAILED) { perror("Erro no mmap"); return NULL; }
+    return map;
+}
+
+void hw_unmap(volatile void *addr, size_t size) {
+    if (addr) munmap((void *)addr, size);
+}
+
+void hw_close(void) {
+    if (hw_fd != -1) close(hw_fd);
+    hw_fd = -1;
+}
+
+HwBackend hw_backend(void) {
+    return hw_current_backend;
+}
+
+/*
+ * No arquivo substituto escrever 1 ligaria o bit em vez de apagá-lo, e o
+ * registrador é compartilhado com o processo que simula os botões, então a
+ * captura é apagada e ligada com operações atômicas na memória compartilhada.
+ */
+unsigned int keys_take_edges(volatile unsigned int *keys) {
+    if (hw_current_backend == HW_BACKEND_FILE) {
+        return __atomic_exchange_n(&keys[PIO_EDGECAPTURE], 0, __ATOMIC_ACQ_REL) & KEY_MASK;
+    }
+    unsigned int edges = keys[PIO_EDGECAPTURE] & KEY_MASK;
+    if (edges) keys[PIO_EDGECAPTURE] = edges;
+    return edges;
+}
+
+void keys_clear_edges(volatile unsigned int *keys) {
+    keys_take_edges(keys);
+}
+
+void keys_sim_write(volatile unsigned int *keys, unsigned int level) {
+    unsigned int prev = keys[PIO_DATA];
+    keys[PIO_DATA] = level & KEY_MASK;
+    __atomic_fetch_or(&keys[PIO_EDGECAPTURE], level & ~prev & KEY_MASK, __ATOMIC_ACQ_REL);
+}
+
+/*
+ * O FIFO é aberto para leitura e escrita: com um escritor sempre aberto, poll()
+ * não devolve POLLHUP quando o simulador fecha a sua ponta.
+ */
+int hw_irq_open(HwIrq *irq, const char *path, volatile unsigned int *keys) {
+    irq->uio = hw_current_backend == HW_BACKEND_MMIO;
+    if (!irq->uio && mkfifo(path, 0666) == -1 && errno != EEXIST) {
+        perror("Erro ao criar o FIFO da interrupção");
+        return -1;
+    }
+    irq->fd = open(path, O_RDWR | (irq->uio ? 0 : O_NONBLOCK));
+    if (irq->fd == -1) { perror("Erro ao abrir o dispositivo da interrupção"); return -1; }
+    keys[PIO_INTERRUPTMASK] = KEY_MASK;
+    return 0;
+}
+
+int hw_irq_wait(HwIrq *irq, int wake_fd, int timeout_ms) {
+    if (irq->uio) {
+        // A PIO mantém a IRQ ativa enquanto houver bordas capturadas: quem chama
+        // já as apagou, e um aperto depois disso dispara logo que a IRQ é reabilitada.
+        uint32_t enable = 1;
+        if (write(irq->fd, &enable, sizeof(enable)) != sizeof(enable)) {
+            perror("Erro ao reabilitar a interrupção");
+            return -1;
+        }
+    }
+    struct pollfd fds[2] = { { irq->fd, POLLIN, 0 }, { wake_fd, POLLIN, 0 } };
+    int n = poll(fds, wake_fd >= 0 ? 2 : 1, timeout_ms);
+    if (n < 0) {
+        if (errno == EINTR) return 0;
+        perror("Erro no poll da interrupção");
+        return -1;
+    }
+    if (!(fds[0].revents & POLLIN)) return 0;
+    if (irq->uio) {
+        uint32_t count;
+        if (read(irq->fd, &count, sizeof(count)) != sizeof(count)) { perror("Erro ao ler a interrupção"); return -1; }
+    } else {
+        char buf[64];
+        while (read(irq->fd, buf, sizeof(buf)) > 0) {}
+    }
+    return 1;
+}
+
+void hw_irq_close(HwIrq *irq, volatile unsigned int *keys) {
+    if (keys) keys[PIO_INTERRUPTMASK] = 0;
+    if (irq->fd != -1) close(irq->fd);
+    irq->fd = -1;
+}
+
+void hw_irq_notify(const char *path) {
+    int fd = open(path, O_WRONLY | O_NONBLOCK); // Falha com ENXIO se ninguém espera
+    if (fd == -1) return;
+    char c = 1;
+    if (write(fd, &c, 1) < 0) {} // FIFO cheio: já há aviso pendente
+    close(fd);
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * Emulação do controlador para o backend de arquivo: no arquivo, escrever 1 em
+ * PIXBUF_BUFFER apagaria o endereço do front buffer, então o pedido de troca só
+ * liga o bit S, e a troca acontece no primeiro "vsync" (múltiplo de 16,67 ms)
+ * depois do pedido, como no hardware.
+ */
+static uint64_t pixbuf_sim_swap_at = 0;
+
+static void pixbuf_sim_update(volatile unsigned int *regs) {
+    if (!(regs[PIXBUF_STATUS] & PIXBUF_STATUS_S) || now_ns() < pixbuf_sim_swap_at) return;
+    unsigned int front = regs[PIXBUF_BUFFER];
+    regs[PIXBUF_BUFFER] = regs[PIXBUF_BACKBUFFER];
+    regs[PIXBUF_BACKBUFFER] = front;
+    regs[PIXBUF_STATUS] &= ~PIXBUF_STATUS_S;
+}
+
+int pixbuf_init(PixelBuffer *pb, volatile void *peripherals) {
+    pb->regs = (volatile unsigned int *)(peripherals + PIXEL_BUF_CTRL_OFFSET);
+    if (hw_current_backend == HW_BACKEND_FILE && pb->regs[PIXBUF_BUFFER] == 0) {
+        // Arquivo recém-criado: valores de reset do controlador.
+        pb->regs[PIXBUF_BUFFER] = FRAME_BASE;
+        pb->regs[PIXBUF_BACKBUFFER] = FRAME_BASE;
+        pb->regs[PIXBUF_RESOLUTION] = (VISIBLE_HEIGHT << 16) | VISIBLE_WIDTH;
+        pb->regs[PIXBUF_STATUS] = 0;
+    }
+    pixbuf_wait_swap(pb);
+
+    unsigned int front = pb->regs[PIXBUF_BUFFER];
+    pb->phys[0] = front;
+    pb->phys[1] = front == SDRAM_BASE ? FRAME_BASE : SDRAM_BASE;
+    for (int i = 0; i < 2; i++) {
+        pb->buffers[i] = (volatile uint16_t (*)[LWIDTH])hw_map(pb->phys[i], FRAME_SIZE);
+        if (!pb->buffers[i]) {
+            if (i == 1) hw_unmap(pb->buffers[0], FRAME_SIZE);
+            return -1;
+        }
+    }
+    pb->back = 1;
+    pb->regs[PIXBUF_BACKBUFFER] = pb->phys[1];
+    return 0;
+}
+
+void pixbuf_request_swap(PixelBuffer *pb) {
+    if (hw_current_backend == HW_BACKEND_FILE) {
+        pb->regs[PIXBUF_STATUS] |= PIXBUF_STATUS_S;
+        pixbuf_sim_swap_at = (now_ns() / VSYNC_PERIOD_NS + 1) * VSYNC_PERIOD_NS;
+    } else {
+        pb->regs[PIXBUF_BUFFER] = 1;
+    }
+    pb->back ^= 1;
+}
+
+int pixbuf_swap_done(PixelBuffer *pb) {
+    if (hw_current_backend == HW_BACKEND_FILE) pixbuf_sim_update(pb->regs);
+    return !(pb->regs[PIXBUF_STATUS] & PIXBUF_STATUS_S);
+}
+
+void pixbuf_wait_swap(PixelBuffer *pb) {
+    while (!pixbuf_swap_done(pb)) usleep(100);
+}
+
+void pixbuf_release(PixelBuffer *pb) {
+    if (!pb->regs) return;
+    pixbuf_wait_swap(pb);
+    if (pb->regs[PIXBUF_BUFFER] != FRAME_BASE) {
+        // Copia a tela atual para FRAME_BASE antes de exibi-lo de novo.
+        int front = pb->back ^ 1;
+        for (int y = 0; y < VISIBLE_HEIGHT; y++) {
+            for (int x = 0; x < VISIBLE_WIDTH; x++) pb->buffers[pb->back][y][x] = pb->buffers[front][y][x];
+        }
+        pb->regs[PIXBUF_BACKBUFFER] = FRAME_BASE;
+        pixbuf_request_swap(pb);
+        pixbuf_wait_swap(pb);
+    }
+    hw_unmap(pb->buffers[0], FRAME_SIZE);
+    hw_unmap(pb->buffers[1], FRAME_SIZE);
+    pb->regs = NULL;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file de1soc.h
+ * @brief Camada de acesso ao hardware da DE1-SoC (VGA, KEY, SW, HEX).
+ *
+ * Centraliza os endereços físicos dos periféricos e o mapeamento de memória.
+ * Dois backends são suportados:
+ * - HW_BACKEND_MMIO: /dev/mem na placa (comportamento original).
+ * - HW_BACKEND_FILE: um arquivo comum (ou objeto em /dev/shm) usado como
+ *   substituto do /dev/mem. Cada endereço físico vira o mesmo offset dentro
+ *   do arquivo, então o jogo roda sem a placa e outro processo pode escrever
+ *   nos registradores de KEY/SW (ver tools/de1soc_sim.c) para roteirizar a partida.
+ */
+#ifndef DE1SOC_H
+#define DE1SOC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// --- Endereços físicos dos periféricos ---
+#define PERIPHERAL_BASE 0xFF200000
+#define PERIPHERAL_SIZE 0x00010000
+#define LEDR_OFFSET     0x0000
+#define HEX3_0_OFFSET   0x0020
+#define HEX5_4_OFFSET   0x0030
+#define SWITCHES_OFFSET 0x0040
+#define DEVICES_BUTTONS 0x0050
+#define PIXEL_BUF_CTRL_OFFSET 0x3020
+
+// --- Framebuffer da VGA ---
+#define FRAME_BASE      0xC8000000
+#define LWIDTH          512
+#define VISIBLE_WIDTH   320
+#define VISIBLE_HEIGHT  240
+#define PIXEL_SIZE      2
+#define FRAME_SIZE      (LWIDTH * VISIBLE_HEIGHT * PIXEL_SIZE)
+
+#define HW_MEM_DEVICE   "/dev/mem"
+
+// --- PIO dos botões (registradores a partir de DEVICES_BUTTONS) ---
+#define PIO_DATA          0 // Nível atual de KEY0-KEY3
+#define PIO_INTERRUPTMASK 2
+#define PIO_EDGECAPTURE   3 // Bit ligado a cada aperto até ser apagado; escrever 1 apaga o bit
+#define KEY_MASK          0xF
+
+// --- Controlador DMA do pixel buffer (registradores a partir de PIXEL_BUF_CTRL_OFFSET) ---
+#define SDRAM_BASE        0xC0000000 // Segundo buffer de quadro, na SDRAM do FPGA
+#define PIXBUF_BUFFER     0          // Front buffer (escrever 1 pede a troca no próximo vsync)
+#define PIXBUF_BACKBUFFER 1          // Endereço do back buffer
+#define PIXBUF_RESOLUTION 2          // (altura << 16) | largura
+#define PIXBUF_STATUS     3          // Bit S = troca pendente
+#define PIXBUF_STATUS_S   0x1
+#define VSYNC_PERIOD_NS   16666667ull
+
+/**
+ * Page flipping com dois buffers de quadro: o on-chip (FRAME_BASE) e um na
+ * SDRAM. O desenho é feito no back buffer e a troca ocorre no vsync, sem memcpy.
+ */
+typedef struct {
+    volatile unsigned int *regs;
+    volatile uint16_t (*buffers[2])[LWIDTH];
+    uint32_t phys[2];
+    int back; // Índice em buffers[] do back buffer atual
+} PixelBuffer;
+
+typedef enum { HW_BACKEND_MMIO, HW_BACKEND_FILE } HwBackend;
+
+/**
+ * @brief Abre o backend de hardware.
+ * @param backend HW_BACKEND_MMIO ou HW_BACKEND_FILE.
+ * @param path Caminho do arquivo substituto (ignorado no backend MMIO).
+ * @return 0 em caso de sucesso, -1 em caso de falha.
+ */
+int hw_open(HwBackend backend, const char *path);
+
+/**
+ * @brief Mapeia uma janela de endereços físicos na memória do programa.
+ * No backend de arquivo o arquivo é estendido se for menor que a janela.
+ * @return Ponteiro para a janela ou NULL em caso de falha.
+ */
+volatile void *hw_map(uint32_t phys_base, size_t size);
+
+void hw_unmap(volatile void *addr, size_t size);
+void hw_close(void);
+HwBackend hw_backend(void);
+
+/**
+ * @brief Mapeia os dois buffers e programa o back buffer do controlador.
+ * @param peripherals Janela já mapeada de PERIPHERAL_BASE.
+ * @return 0 em caso de sucesso, -1 em caso de falha.
+ */
+int pixbuf_init(PixelBuffer *pb, volatile void *peripherals);
+
+// Pede a troca front/back no próximo vsync.
+void pixbuf_request_swap(PixelBuffer *pb);
+
+// @return 1 se não há troca pendente (bit S zerado), sem esperar.
+int pixbuf_swap_done(PixelBuffer *pb);
+
+// Espera o bit S zerar; depois disso o antigo front pode ser desenhado.
+void pixbuf_wait_swap(PixelBuffer *pb);
+
+/**
+ * @brief Lê e apaga as bordas de subida que a PIO dos KEYs capturou desde a
+ * última chamada. Um aperto mais curto que o intervalo entre leituras continua
+ * registrado, ao contrário de comparar dois níveis lidos em momentos diferentes.
+ * @param keys Registradores da PIO (janela mapeada + DEVICES_BUTTONS).
+ * @return Máscara dos KEYs apertados.
+ */
+unsigned int keys_take_edges(volatile unsigned int *keys);
+
+// Descarta apertos capturados antes do programa começar.
+void keys_clear_edges(volatile unsigned int *keys);
+
+/**
+ * @brief Escreve o nível dos KEYs no arquivo substituto, capturando as bordas
+ * de subida como a PIO faria (usado por tools/de1soc_sim.c).
+ */
+void keys_sim_write(volatile unsigned int *keys, unsigned int level);
+
+/**
+ * Interrupção da PIO dos KEYs vista pelo espaço de usuário. Na placa é um
+ * dispositivo UIO (ex.: /dev/uio0, com o driver uio_pdrv_genirq ligado à IRQ
+ * da PIO): escrever 1 reabilita a IRQ e o descritor fica legível quando ela
+ * dispara. No backend de arquivo é um FIFO que tools/de1soc_sim.c escreve a
+ * cada mudança dos KEYs.
+ */
+typedef struct {
+    int fd;
+    int uio; // 1 para UIO, 0 para o FIFO substituto
+} HwIrq;
+
+/**
+ * @brief Abre o dispositivo da interrupção (cria o FIFO no backend de arquivo)
+ * e liga a máscara de interrupção da PIO para todos os KEYs. Não apaga a
+ * captura de bordas: isso fica com quem inicia a leitura (keys_clear_edges()).
+ * @return 0 em caso de sucesso, -1 em caso de falha.
+ */
+int hw_irq_open(HwIrq *irq, const char *path, volatile unsigned int *keys);
+
+/**
+ * @brief Reabilita a interrupção e bloqueia em poll() até ela disparar.
+ * @param wake_fd Outro descritor que também encerra a espera (-1 para nenhum).
+ * @param timeout_ms Limite da espera, -1 para esperar sem limite.
+ * @return 1 se a interrupção disparou, 0 no limite ou por wake_fd, -1 em caso de falha.
+ */
+int hw_irq_wait(HwIrq *irq, int wake_fd, int timeout_ms);
+
+void hw_irq_close(HwIrq *irq, volatile unsigned int *keys);
+
+// Avisa quem espera no FIFO substituto em `path` (não faz nada se ninguém o abriu).
+void hw_irq_notify(const char *path);
+
+// Volta a exibir FRAME_BASE (para outros programas) e desfaz os mapeamentos.
+void pixbuf_release(PixelBuffer *pb);
+
+#endif
@@ -4,171 +4,80 @@
 #include <string.h>
 #include <stdint.h>
 #include <unistd.h>
-#include <fcntl.h>
-#include <sys/mman.h>
 #include <time.h>
 #include <math.h>
 
-#define PERIPHERAL_BASE 0xFF200000
-#define PERIPHERAL_SIZE 0x00010000 
-#define DEVICES_BUTTONS 0x0050
-#define SWITCHES_OFFSET 0x0040
-#define HEX3_0_OFFSET   0x0020
-#define HEX5_4_OFFSET   0x0030
-
-#define FRAME_BASE      0xC8000000
-#define LWIDTH          512
-#define VISIBLE_WIDTH   320
-#define VISIBLE_HEIGHT  240
-#define PIXEL_SIZE      2
-
-#define SPEED_LEVEL_0    2 
-#define SPEED_LEVEL_1    3 
-#define SPEED_LEVEL_2    4 
-#define SPEED_LEVEL_3    5 
-
-#define GAP_EASIEST 100
-#define GAP_EASY     90
-#define GAP_HARD     80
-#define GAP_HARDEST  70
-
-#define NUM_PIPES_EASY 2
-#define NUM_PIPES_HARD 3
-#define SPACING_EASY 220
-#define SPACING_HARD 130 
-
-#define GRAVITY_EASY 0.5
-#define GRAVITY_HARD 0.35
-
-#define JUMP_EASY -5.5
-#define JUMP_HARD -7.0
-
-#define RADIUS_EASY 10
-#define RADIUS_HARD 13
-
-#define P1_X_POS         60
-#define P2_X_POS         90
-#define OBSTACLE_WIDTH   50
-
-#define WHITE    0xFFFF
-#define GREEN    0x07E0 
-#define P1_COLOR 0xFFE0
-#define P2_COLOR 0xF800
-#define BEAK_COLOR 0xFC00
-#define DEAD_COLOR 0x8410
-#define SKY_BLUE 0x841F
-#define BLACK    0x0000
-
-#define FONT_WIDTH 3
-#define FONT_HEIGHT 5
-#define FONT_CHAR_SPACING 2 
-#define FONT_SCALE 2        
-
-const int font_3x5[10][FONT_HEIGHT][FONT_WIDTH] = {
-    {{1,1,1},{1,0,1},{1,0,1},{1,0,1},{1,1,1}}, {{0,1,0},{1,1,0},{0,1,0},{0,1,0},{1,1,1}}, 
-    {{1,1,1},{0,0,1},{1,1,1},{1,0,0},{1,1,1}}, {{1,1,1},{0,0,1},{0,1,1},{0,0,1},{1,1,1}}, 
-    {{1,0,1},{1,0,1},{1,1,1},{0,0,1},{0,0,1}}, {{1,1,1},{1,0,0},{1,1,1},{0,0,1},{1,1,1}},
-    {{1,1,1},{1,0,0},{1,1,1},{1,0,1},{1,1,1}}, {{1,1,1},{0,0,1},{0,1,0},{0,1,0},{0,1,0}},
-    {{1,1,1},{1,0,1},{1,1,1},{1,0,1},{1,1,1}}, {{1,1,1},{1,0,1},{1,1,1},{0,0,1},{1,1,1}}
-};
+#include "de1soc.h"
+#include "flappy.h"
+#include "flappy_core.h"
+#include "flappy_population.h"
+#include "flappy_brain.h"
+#include "flappy_render.h"
+#include "input_log.h"
+#include "input_sampler.h"
+#include "latency_trace.h"
+#include "mmio_shadow.h"
+
 const unsigned char seven_seg_digits[10] = {
     0x3F,0x06,0x5B,0x4F,0x66,0x6D,0x7D,0x07,0x7F,0x6F
 };
 
-typedef enum { GAME_RUNNING, GAME_OVER } GameState;
-typedef struct { double y, velocity_y; int alive; } Bird;
-typedef struct { int x, gap_y, scored; } Obstacle;
-
-int mem_fd = -1;
-volatile uint16_t (*tela)[LWIDTH] = NULL;
 volatile void *peripheral_map = NULL;
 volatile unsigned int *key_ptr = NULL;
 volatile unsigned int *sw_ptr = NULL;
-volatile unsigned int *hex3_0_ptr = NULL;
-volatile unsigned int *hex5_4_ptr = NULL;
+ShadowOutputs outputs = { 0 }; // HEX3_0 e HEX5_4 só são escritos quando o placar muda
+PixelBuffer pixel_buffer = { 0 };
+InputSampler input_sampler = { 0 };
+HwIrq key_irq = { -1, 0 };
+
+// Contadores do laço de tempo fixo.
+typedef struct {
+    unsigned long frames;         // Quadros executados
+    unsigned long overruns;       // Quadros que terminaram depois do prazo
+    unsigned long catchup_steps;  // Passos de física extras para recuperar atrasos
+    unsigned long dropped_frames; // Períodos abandonados por excederem MAX_CATCHUP_STEPS
+} FrameStats;
+
+// Contadores da thread de entrada.
+typedef struct {
+    unsigned long presses;   // Bordas de subida entregues ao laço
+    unsigned long taps;      // Apertados e já soltos no começo do quadro: a leitura por quadro os perderia
+    uint64_t latency_sum_ns; // Do instante em que a thread viu o aperto até o quadro que o consumiu
+    uint64_t latency_max_ns;
+} InputStats;
 
 void cleanup_resources() {
-    if (hex3_0_ptr) *hex3_0_ptr = 0;
-    if (hex5_4_ptr) *hex5_4_ptr = 0;
-    if (tela) munmap((void*)tela, LWIDTH * VISIBLE_HEIGHT * PIXEL_SIZE);
-    if (peripheral_map) munmap((void*)peripheral_map, PERIPHERAL_SIZE);
-    if (mem_fd != -1) close(mem_fd);
+    input_sampler_stop(&input_sampler); // Antes de desmapear o registrador que ela lê
+    hw_irq_close(&key_irq, key_irq.fd != -1 ? key_ptr : NULL);
+    shadow_write(&outputs.hex3_0, 0);
+    shadow_write(&outputs.hex5_4, 0);
+    pixbuf_release(&pixel_buffer);
+    hw_unmap(tela, FRAME_SIZE);
+    hw_unmap(peripheral_map, PERIPHERAL_SIZE);
+    hw_close();
     printf("\nRecursos liberados. Saindo do jogo.\n");
 }
 
-int init_hardware() {
-    mem_fd = open("/dev/mem", O_RDWR | O_SYNC);
-    if (mem_fd == -1) { perror("Erro ao abrir /dev/mem"); return -1; }
+int init_hardware(HwBackend backend, const char *sim_path) {
+    if (hw_open(backend, sim_path) != 0) { return -1; }
     
-    void* vga_map = mmap(NULL, LWIDTH * VISIBLE_HEIGHT * PIXEL_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, mem_fd, FRAME_BASE);
-    if (vga_map == MAP_FAILED) { perror("Erro ao mapear VGA"); close(mem_fd); return -1; }
+    volatile void* vga_map = hw_map(FRAME_BASE, FRAME_SIZE);
+    if (!vga_map) { fprintf(stderr, "Erro ao mapear VGA\n"); hw_close(); return -1; }
     tela = (volatile uint16_t (*)[LWIDTH])vga_map;
 
-    peripheral_map = mmap(NULL, PERIPHERAL_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, mem_fd, PERIPHERAL_BASE);
-    if (peripheral_map == MAP_FAILED) { perror("Erro ao mapear periféricos"); munmap(vga_map, LWIDTH * VISIBLE_HEIGHT * PIXEL_SIZE); close(mem_fd); return -1; }
+    peripheral_map = hw_map(PERIPHERAL_BASE, PERIPHERAL_SIZE);
+    if (!peripheral_map) { fprintf(stderr, "Erro ao mapear periféricos\n"); hw_unmap(vga_map, FRAME_SIZE); hw_close(); return -1; }
     
     key_ptr = (volatile unsigned int *)(peripheral_map + DEVICES_BUTTONS);
     sw_ptr = (volatile unsigned int *)(peripheral_map + SWITCHES_OFFSET);
-    hex3_0_ptr = (volatile unsigned int *)(peripheral_map + HEX3_0_OFFSET);
-    hex5_4_ptr = (volatile unsigned int *)(peripheral_map + HEX5_4_OFFSET);
+    shadow_outputs_init(&outputs, peripheral_map);
 
     atexit(cleanup_resources);
     return 0;
 }
 
-void set_pix(int x, int y, uint16_t color) {
-    if (y >= 0 && y < VISIBLE_HEIGHT && x >= 0 && x < VISIBLE_WIDTH) {
-        tela[y][x] = color;
-    }
-}
-
-void draw_filled_rect(int x0, int y0, int x1, int y1, uint16_t color) {
-    for (int y = y0; y < y1; y++) {
-        for (int x = x0; x < x1; x++) {
-            set_pix(x, y, color);
-        }
-    }
-}
-
-void draw_circle(int xc, int yc, int r, uint16_t color) {
-    for (int y = -r; y <= r; y++) {
-        for (int x = -r; x <= r; x++) {
-            if (x * x + y * y <= r * r) {
-                set_pix(xc + x, yc + y, color);
-            }
-        }
-    }
-}
-
-void draw_digit(int digit, int x, int y, uint16_t color) {
-    if (digit < 0 || digit > 9) return;
-    for (int row = 0; row < FONT_HEIGHT; row++) {
-        for (int col = 0; col < FONT_WIDTH; col++) {
-            if (font_3x5[digit][row][col] == 1) {
-                draw_filled_rect(x + (col * FONT_SCALE), y + (row * FONT_SCALE),
-                                 x + (col * FONT_SCALE) + FONT_SCALE, y + (row * FONT_SCALE) + FONT_SCALE,
-                                 color);
-            }
-        }
-    }
-}
-
-void draw_score(int score, int x, int y, uint16_t color) {
-    char score_text[10];
-    sprintf(score_text, "%d", score);
-    int len = strlen(score_text);
-    int current_x = x;
-
-    for (int i = len - 1; i >= 0; i--) {
-        int digit = score_text[i] - '0';
-        int char_width = (FONT_WIDTH * FONT_SCALE);
-        current_x -= char_width;
-        draw_digit(digit, current_x, y, color);
-        current_x -= FONT_CHAR_SPACING;
-    }
-}
-
 void update_hex_displays(int score1, int score2) {
+    if (!outputs.hex3_0.reg) return; // Repetição sem placa
     if (score1 > 99) score1 = 99;
     if (score2 > 99) score2 = 99;
 
@@ -176,231 +85,438 @@ void update_hex_displays(int score1, int score2) {
     int p1_unidade = score1 % 10;
     unsigned char p1_code_d = seven_seg_digits[p1_dezena];
     unsigned char p1_code_u = seven_seg_digits[p1_unidade];
-    *hex3_0_ptr = (p1_code_d << 8) | p1_code_u;
+    shadow_write(&outputs.hex3_0, (p1_code_d << 8) | p1_code_u);
 
     int p2_dezena = score2 / 10;
     int p2_unidade = score2 % 10;
     unsigned char p2_code_d = seven_seg_digits[p2_dezena];
     unsigned char p2_code_u = seven_seg_digits[p2_unidade];
-    *hex5_4_ptr = (p2_code_d << 8) | p2_code_u;
+    shadow_write(&outputs.hex5_4, (p2_code_d << 8) | p2_code_u);
 }
 
-void fill_screen(uint16_t color) {
-    for (int y = 0; y < VISIBLE_HEIGHT; y++) {
-        for (int x = 0; x < VISIBLE_WIDTH; x++) {
-            tela[y][x] = color;
-        }
+static void announce_game(const GameConfig *cfg, const BirdPopulation *pop, const Genome *brain) {
+    if (pop) {
+        printf("Iniciando população de %d pássaros no piloto automático. KEY1/KEY2 recomeçam. ", pop->count);
+    } else {
+        printf(brain ? "Iniciando Jogo! P1 (Amarelo) é controlado pelo genoma. " : "Iniciando Jogo! P1 (Amarelo) usa KEY1. ");
+        if (cfg->two_player) printf("P2 (Vermelho) usa KEY2. ");
     }
+    printf("KEY0 para Sair.\n");
+    fflush(stdout);
 }
 
-void draw_flappy_bird(int x, int y, uint16_t body_color, int bird_radius) {
-    draw_circle(x, y, bird_radius, body_color);
-    draw_circle(x + bird_radius / 2, y - bird_radius / 3, bird_radius / 4, WHITE);
-    set_pix(x + bird_radius / 2, y - bird_radius / 3, BLACK);
-    draw_filled_rect(x + bird_radius, y - 2, x + bird_radius + 5, y + 2, BEAK_COLOR);
-    draw_filled_rect(x - bird_radius / 2, y, x, y + 5, WHITE);
+// Partida nova; no modo população só a população joga e as folgas mudam a cada partida.
+static void start_game(Game *game, BirdPopulation *pop, const GameConfig *cfg) {
+    game_reset(game, cfg);
+    if (!pop) return;
+    population_reset(pop, cfg, game->rng);
+    game->p1.alive = 0;
+    game->p2.alive = 0;
 }
 
-int check_collision(const Bird* bird, int bird_x_pos, const Obstacle* obs, int bird_radius, int gap_height) {
-    if ((bird->y - bird_radius) < 0 || (bird->y + bird_radius) > VISIBLE_HEIGHT) {
-        return 1;
+/**
+ * @brief Acumula (FNV-1a) o estado da partida após um quadro. Se uma gravação
+ * repetida produz o mesmo hash final que a sessão original, a otimização
+ * testada não mudou o resultado do jogo.
+ */
+static uint32_t hash_game(uint32_t h, const Game *game) {
+    int32_t fields[12 + 3 * MAX_OBSTACLES] = {
+        game->p1.y, game->p1.velocity_y, game->p1.alive, game->p2.y, game->p2.velocity_y, game->p2.alive,
+        game->score_p1, game->score_p2, game->state, (int32_t)game->rng, game->num_obstacles, game->first_obstacle
+    };
+    for (int i = 0; i < MAX_OBSTACLES; i++) {
+        fields[12 + 3 * i] = game->obstacles[i].x;
+        fields[13 + 3 * i] = game->obstacles[i].gap_y;
+        fields[14 + 3 * i] = game->obstacles[i].scored;
     }
-    if (bird_x_pos + bird_radius > obs->x && bird_x_pos - bird_radius < obs->x + OBSTACLE_WIDTH) {
-        if (bird->y - bird_radius < obs->gap_y || bird->y + bird_radius > obs->gap_y + gap_height) {
-            return 1;
+    const unsigned char *bytes = (const unsigned char *)fields;
+    for (size_t i = 0; i < sizeof(fields); i++) {
+        h ^= bytes[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/**
+ * @brief Esvazia a fila da thread de entrada: o nível dos KEYs passa a ser o
+ * do último evento, e todo KEY capturado em algum evento conta como apertado
+ * no quadro, mesmo que já tenha sido solto.
+ */
+static void drain_input(InputSampler *s, unsigned int prev_keys, InputFrame *input, InputStats *stats,
+                        uint64_t *p1_press_ns) {
+    uint64_t now = input_now_ns();
+    unsigned int keys = prev_keys, pressed = 0;
+    KeyEvent ev;
+    while (input_sampler_pop(s, &ev)) {
+        unsigned int down = ev.pressed;
+        if ((down & 0b0010) && !(pressed & 0b0010)) *p1_press_ns = ev.t_ns;
+        if (down) {
+            uint64_t latency = now - ev.t_ns;
+            stats->presses += __builtin_popcount(down);
+            stats->latency_sum_ns += latency * __builtin_popcount(down);
+            if (latency > stats->latency_max_ns) stats->latency_max_ns = latency;
         }
+        pressed |= down;
+        keys = ev.keys;
     }
-    return 0;
+    stats->taps += __builtin_popcount(pressed & ~keys);
+    input->keys = keys;
+    input->pressed = pressed;
 }
 
-void reset_game(Bird* p1, Bird* p2, Obstacle obstacles[], int num_obstacles, int* score1, int* score2, int is_two_player_mode, int spacing, int gap_height) {
-    p1->y = VISIBLE_HEIGHT / 2.0;
-    p1->velocity_y = 0;
-    p1->alive = 1;
+static void timespec_add_ns(struct timespec *t, long long ns) {
+    long long total = t->tv_nsec + ns;
+    t->tv_sec += total / 1000000000LL;
+    t->tv_nsec = total % 1000000000LL;
+}
 
-    *score1 = 0;
-    *score2 = 0;
+static long long timespec_diff_ns(const struct timespec *a, const struct timespec *b) {
+    return (a->tv_sec - b->tv_sec) * 1000000000LL + (a->tv_nsec - b->tv_nsec);
+}
 
-    if (is_two_player_mode) {
-        p2->y = VISIBLE_HEIGHT / 2.0;
-        p2->velocity_y = 0;
-        p2->alive = 1;
-    } else {
-        p2->alive = 0; 
+/**
+ * @brief Avança o prazo absoluto em um período e dorme até ele.
+ * Se o quadro passou do prazo, não dorme: devolve quantos passos de física
+ * recuperar (até MAX_CATCHUP_STEPS) e descarta o atraso que sobrar.
+ * @return Número de passos de física a executar no próximo quadro.
+ */
+static int wait_next_frame(struct timespec *deadline, FrameStats *stats) {
+    struct timespec now;
+    stats->frames++;
+    timespec_add_ns(deadline, FRAME_PERIOD_NS);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    long long late = timespec_diff_ns(&now, deadline);
+    if (late < 0) {
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, deadline, NULL) != 0) {}
+        return 1;
     }
 
-    for (int i = 0; i < num_obstacles; i++) {
-        obstacles[i].x = VISIBLE_WIDTH + 150 + i * spacing;
-        obstacles[i].gap_y = rand() % (VISIBLE_HEIGHT - gap_height - 60) + 30;
-        obstacles[i].scored = 0;
+    stats->overruns++;
+    long long missed = late / FRAME_PERIOD_NS;
+    timespec_add_ns(deadline, missed * FRAME_PERIOD_NS);
+    int steps = 1 + (int)missed;
+    if (steps > MAX_CATCHUP_STEPS) {
+        stats->dropped_frames += steps - MAX_CATCHUP_STEPS;
+        steps = MAX_CATCHUP_STEPS;
     }
-    
-    if (num_obstacles < 3) {
-        obstacles[2].x = -OBSTACLE_WIDTH -10;
+    stats->catchup_steps += steps - 1;
+    return steps;
+}
+
+/**
+ * @brief Com uma troca de buffers pendente, espera ela acontecer sem passar do
+ * prazo do próximo quadro, para a marca de envio ser tirada na troca e não só
+ * quando o quadro seguinte for desenhar.
+ * @param deadline Prazo do quadro atual (wait_next_frame ainda não o avançou).
+ * @return 1 se a troca aconteceu antes do prazo.
+ */
+static int wait_swap_before(PixelBuffer *pb, const struct timespec *deadline) {
+    struct timespec until = *deadline, now;
+    timespec_add_ns(&until, FRAME_PERIOD_NS);
+    for (;;) {
+        if (pixbuf_swap_done(pb)) return 1;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (timespec_diff_ns(&now, &until) >= 0) return 0;
+        usleep(100);
     }
-    
-    printf("Iniciando Jogo! P1 (Amarelo) usa KEY1. ");
-    if(is_two_player_mode) printf("P2 (Vermelho) usa KEY2. ");
-    printf("KEY0 para Sair.\n");
-    fflush(stdout);
 }
 
-int main() {
-    if (init_hardware() != 0) { return 1; }
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Uso: %s [--sim <arquivo>] [--flip] [--seed <n>|sw] [--record <arquivo> | --population <n>] [--brain <genoma>]\n"
+        "       [--no-input-thread | --irq <dispositivo>] [--latency-csv <arquivo>]\n"
+        "       %s --replay <arquivo> [--no-render] [--brain <genoma>]\n", prog, prog);
+}
 
-    uint16_t* back_buffer = malloc(LWIDTH * VISIBLE_HEIGHT * PIXEL_SIZE);
-    if (!back_buffer) { perror("Erro ao alocar o back buffer"); return 1; }
+int main(int argc, char **argv) {
+    HwBackend backend = HW_BACKEND_MMIO;
+    const char *sim_path = NULL;
+    int page_flip = 0;
+    const char *seed_arg = NULL;
+    const char *record_path = NULL;
+    const char *replay_path = NULL;
+    int render = 1;
+    int input_thread = 1;
+    const char *irq_path = NULL;
+    const char *latency_csv = NULL;
+    int population_size = 0;
+    const char *brain_path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--sim") == 0 && i + 1 < argc) {
+            backend = HW_BACKEND_FILE;
+            sim_path = argv[++i];
+        } else if (strcmp(argv[i], "--flip") == 0) {
+            page_flip = 1;
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed_arg = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--no-render") == 0) {
+            render = 0;
+        } else if (strcmp(argv[i], "--no-input-thread") == 0) {
+            input_thread = 0;
+        } else if (strcmp(argv[i], "--irq") == 0 && i + 1 < argc) {
+            irq_path = argv[++i];
+        } else if (strcmp(argv[i], "--latency-csv") == 0 && i + 1 < argc) {
+            latency_csv = argv[++i];
+        } else if (strcmp(argv[i], "--population") == 0 && i + 1 < argc) {
+            population_size = atoi(argv[++i]);
+            if (population_size <= 0) { usage(argv[0]); return 1; }
+        } else if (strcmp(argv[i], "--brain") == 0 && i + 1 < argc) {
+            brain_path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    int replaying = replay_path != NULL;
+    // A gravação não guarda o tamanho da população, então os dois modos não se misturam.
+    if ((replaying && (record_path || sim_path || page_flip || seed_arg || population_size)) ||
+        (!replaying && !render) || (record_path && population_size) || (irq_path && (replaying || !input_thread)) ||
+        (replaying && latency_csv)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // Piloto automático treinado por tools/flappy_train.c; na repetição, passe o mesmo genoma da gravação.
+    Genome genome, *brain = NULL;
+    if (brain_path) {
+        unsigned int trained_sw;
+        uint32_t fitness;
+        if (genome_load(&genome, brain_path, &trained_sw, &fitness) != 0) { return 1; }
+        printf("Genoma %s: treinado com SW 0x%03X, aptidão %u quadros\n", brain_path, trained_sw, fitness);
+        brain = &genome;
+    }
+
+    // A repetição não usa a placa: as entradas vêm do arquivo e a tela fica na RAM.
+    InputLog input_log = { 0 };
+    uint16_t *replay_screen = NULL;
+    if (replaying) {
+        if (input_log_open(&input_log, replay_path) != 0) { return 1; }
+        if (render) {
+            replay_screen = alloc_frame();
+            if (!replay_screen) { perror("Erro ao alocar a tela da repetição"); return 1; }
+            tela = (volatile uint16_t (*)[LWIDTH])replay_screen;
+        }
+    } else {
+        if (init_hardware(backend, sim_path) != 0) { return 1; }
+        // Única limpeza da captura de bordas: antes da IRQ e da thread de entrada.
+        keys_clear_edges(key_ptr);
+        // A thread de entrada dorme na IRQ da PIO dos KEYs em vez de ler o registrador a 2 kHz.
+        if (irq_path && hw_irq_open(&key_irq, irq_path, key_ptr) != 0) { return 1; }
+        if (input_thread && input_sampler_start(&input_sampler, key_ptr, irq_path ? &key_irq : NULL) != 0) { return 1; }
+        if (page_flip && pixbuf_init(&pixel_buffer, peripheral_map) != 0) {
+            fprintf(stderr, "Erro ao mapear os buffers do page flipping\n");
+            return 1;
+        }
+    }
 
-    srand(time(NULL));
+    DirtyRenderer renderer = { 0 };
+    if (render && dirty_renderer_init(&renderer, page_flip ? 2 : 1) != 0) { perror("Erro ao alocar o back buffer"); return 1; }
 
-    Obstacle obstacles[3]; 
+    // Os sprites dos dois raios (SW7) ficam prontos antes do jogo; trocar SW7 só escolhe o outro.
+    prepare_bird_tables(RADIUS_EASY);
+    prepare_bird_tables(RADIUS_HARD);
 
-    Bird player1, player2;
-    GameState state = GAME_RUNNING;
-    unsigned int prev_key_state = 0x0;
-    
-    int score_p1, score_p2;
+    Game game;
+    GameConfig cfg;
+    BirdPopulation population, *pop = NULL;
+    if (population_size) {
+        if (population_init(&population, population_size) != 0) { perror("Erro ao alocar a população"); return 1; }
+        pop = &population;
+    }
+    unsigned int key_level = 0x0; // Nível dos KEYs no último quadro: ponto de partida de drain_input
     int high_score_p1 = 0, high_score_p2 = 0;
-    
-    int is_two_player_mode = (*(volatile unsigned int *)(peripheral_map + SWITCHES_OFFSET)) & 0x100;
-    reset_game(&player1, &player2, obstacles, NUM_PIPES_EASY, &score_p1, &score_p2, is_two_player_mode, SPACING_EASY, GAP_EASY);
+
+    // Semente: --seed <n>, ou --seed sw para usar os switches do início; sem a opção, o relógio.
+    uint32_t seed = (uint32_t)time(NULL);
+    unsigned int initial_switches = replaying ? input_log.switches : *sw_ptr;
+    if (replaying) seed = input_log.seed;
+    else if (seed_arg) seed = strcmp(seed_arg, "sw") == 0 ? initial_switches : (uint32_t)strtoul(seed_arg, NULL, 0);
+    game_seed(&game, seed);
+    printf("Semente dos canos: %u\n", seed);
+    if (record_path && input_log_create(&input_log, record_path, seed, initial_switches) != 0) { return 1; }
+
+    game_config_from_switches(&cfg, initial_switches);
+    prepare_bird_tables(cfg.bird_radius);
+    unsigned long config_rebuilds = 0;
+    start_game(&game, pop, &cfg);
+    if (!replaying) announce_game(&cfg, pop, brain);
     update_hex_displays(high_score_p1, high_score_p2);
 
+    FrameStats frame_stats = { 0, 0, 0, 0 };
+    InputStats input_stats = { 0, 0, 0, 0 };
+    // Marcas do aperto de KEY1 deste quadro. Com --flip o envio só termina na troca, então as
+    // marcas vão para pending_marks até o bit S zerar, e um aperto no quadro seguinte não as sobrescreve.
+    LatencyTrace latency;
+    uint64_t marks[LATENCY_MARKS], pending_marks[LATENCY_MARKS];
+    unsigned long pending_frame = 0;
+    int marks_pending = 0;
+    if (!replaying && latency_trace_open(&latency, latency_csv) != 0) { return 1; }
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    struct timespec replay_start = deadline;
+    int physics_steps = 1;
+    uint32_t state_hash = 2166136261u;
+
     while (1) {
-        unsigned int current_key_state = *key_ptr;
-        unsigned int switch_state = *sw_ptr; 
-        
-        is_two_player_mode = switch_state & 0x100;
-        int is_paused = switch_state & 0x200;
-
-        int num_obstacles;
-        int current_spacing;
-        if (switch_state & (1 << 4)) {
-            num_obstacles = NUM_PIPES_HARD;
-            current_spacing = SPACING_HARD;
+        InputFrame input = { 0, 0, 0, physics_steps };
+        uint64_t p1_press_ns = 0;
+        if (replaying) {
+            int r = input_log_read(&input_log, &input);
+            if (r < 0) fprintf(stderr, "Gravação truncada no quadro %lu\n", frame_stats.frames);
+            if (r <= 0) break;
+            physics_steps = input.physics_steps;
         } else {
-            num_obstacles = NUM_PIPES_EASY;
-            current_spacing = SPACING_EASY;
+            if (input_sampler.running) {
+                drain_input(&input_sampler, key_level, &input, &input_stats, &p1_press_ns);
+            } else {
+                input.keys = *key_ptr & KEY_MASK;
+                input.pressed = keys_take_edges(key_ptr);
+                if (input.pressed & 0b0010) p1_press_ns = input_now_ns();
+            }
+            input.switches = *sw_ptr;
+            if (record_path && input_log_write(&input_log, &input) != 0) break;
         }
+        key_level = input.keys;
+        unsigned int switch_state = input.switches;
         
-        int current_speed;
-        switch (switch_state & 0b11) {
-            case 0b00: current_speed = SPEED_LEVEL_0; break;
-            case 0b01: current_speed = SPEED_LEVEL_1; break;
-            case 0b10: current_speed = SPEED_LEVEL_2; break;
-            case 0b11: current_speed = SPEED_LEVEL_3; break;
+        // SW quase nunca muda: a configuração e as tabelas do raio só são refeitas quando muda.
+        if (game_config_update(&cfg, switch_state)) {
+            prepare_bird_tables(cfg.bird_radius);
+            config_rebuilds++;
         }
 
-        int current_gap_height;
-        switch ((switch_state >> 2) & 0b11) {
-            case 0b00: current_gap_height = GAP_EASIEST; break;
-            case 0b01: current_gap_height = GAP_EASY;    break;
-            case 0b10: current_gap_height = GAP_HARD;    break;
-            case 0b11: current_gap_height = GAP_HARDEST; break;
-        }
-
-        double current_gravity = (switch_state & (1 << 5)) ? GRAVITY_HARD : GRAVITY_EASY;
-        double current_jump_velocity = (switch_state & (1 << 6)) ? JUMP_HARD : JUMP_EASY;
-        int current_bird_radius = (switch_state & (1 << 7)) ? RADIUS_HARD : RADIUS_EASY;
-
-        if (current_key_state & 0b0001) { break; } 
+        unsigned int pressed = input.pressed;
+        if ((input.keys | pressed) & 0b0001) { break; } 
 
-        switch(state) {
+        switch(game.state) {
             case GAME_RUNNING: {
-                if (!is_paused) {
-                    if (player1.alive) {
-                        if ((current_key_state & 0b0010) && !(prev_key_state & 0b0010)) {
-                            player1.velocity_y = current_jump_velocity;
-                        }
-                    }
-                    if (player2.alive) {
-                        if ((current_key_state & 0b0100) && !(prev_key_state & 0b0100)) {
-                            player2.velocity_y = current_jump_velocity;
-                        }
-                    }
-                    if(player1.alive) {
-                        player1.velocity_y += current_gravity;
-                        player1.y += player1.velocity_y;
-                    }
-                    if(player2.alive) {
-                        player2.velocity_y += current_gravity;
-                        player2.y += player2.velocity_y;
-                    }
-                    for (int i = 0; i < num_obstacles; i++) {
-                        obstacles[i].x -= current_speed;
-                        if (!obstacles[i].scored && obstacles[i].x + OBSTACLE_WIDTH < P1_X_POS) {
-                            obstacles[i].scored = 1;
-                            if (player1.alive) score_p1++;
-                            if (player2.alive) score_p2++;
-                        }
-                        if (obstacles[i].x + OBSTACLE_WIDTH < 0) {
-                            int max_x = 0;
-                            for (int j = 0; j < num_obstacles; j++) {
-                                if (obstacles[j].x > max_x) {
-                                    max_x = obstacles[j].x;
-                                }
-                            }
-                            obstacles[i].x = max_x + current_spacing;
-                            obstacles[i].gap_y = rand() % (VISIBLE_HEIGHT - current_gap_height - 60) + 30;
-                            obstacles[i].scored = 0;
-                        }
-                    }
-                    for (int i = 0; i < num_obstacles; i++) {
-                        if (player1.alive && check_collision(&player1, P1_X_POS, &obstacles[i], current_bird_radius, current_gap_height)) {
-                            player1.alive = 0;
-                        }
-                        if (player2.alive && check_collision(&player2, P2_X_POS, &obstacles[i], current_bird_radius, current_gap_height)) {
-                            player2.alive = 0;
-                        }
-                    }
-                    int game_is_over = 0;
-                    if(is_two_player_mode) { if(!player1.alive && !player2.alive) game_is_over = 1; } 
-                    else { if(!player1.alive) game_is_over = 1; }
-
-                    if(game_is_over) {
-                        state = GAME_OVER;
-                        if (score_p1 > high_score_p1) high_score_p1 = score_p1;
-                        if (score_p2 > high_score_p2) high_score_p2 = score_p2;
+                unsigned int inputs = ((pressed & 0b0010) ? INPUT_JUMP_P1 : 0) | ((pressed & 0b0100) ? INPUT_JUMP_P2 : 0);
+                // Só apertos que viram pulo entram no traço: pausado, com P1 já caído ou
+                // sem passo de física neste quadro, o aperto não chega à tela.
+                int jumped = !cfg.paused && game.p1.alive && physics_steps > 0 && (inputs & INPUT_JUMP_P1);
+                // Um passo de física por período; após um atraso, os passos perdidos são recuperados.
+                for (int step = 0; step < physics_steps && game.state == GAME_RUNNING; step++) {
+                    if (pop) {
+                        population_step(pop, &game, &cfg);
+                        game.score_p1 = pop->passed;
+                    } else {
+                        // O genoma decide a cada passo, como no treino; KEY1 continua valendo.
+                        unsigned int step_inputs = step == 0 ? inputs : 0;
+                        if (brain && brain_jump(brain, &game.p1, P1_X_POS, &game, &cfg)) step_inputs |= INPUT_JUMP_P1;
+                        game_step(&game, step_inputs, &cfg);
                     }
                 }
+                int traced = p1_press_ns && jumped && !pop && render;
+                if (traced) {
+                    marks[LATENCY_SAMPLE] = p1_press_ns;
+                    marks[LATENCY_PHYSICS] = input_now_ns();
+                }
+                if (game.state == GAME_OVER) {
+                    if (pop) printf("Todos os %d pássaros caíram depois de %d canos.\n", pop->count, pop->passed);
+                    if (game.score_p1 > high_score_p1) high_score_p1 = game.score_p1;
+                    if (game.score_p2 > high_score_p2) high_score_p2 = game.score_p2;
+                }
 
-                volatile uint16_t (*original_tela_ptr)[LWIDTH] = tela;
-                tela = (volatile uint16_t (*)[LWIDTH])back_buffer;
-
-                fill_screen(SKY_BLUE);
-                for (int i = 0; i < num_obstacles; i++) {
-                    draw_filled_rect(obstacles[i].x, 0, obstacles[i].x + OBSTACLE_WIDTH, obstacles[i].gap_y, GREEN);
-                    draw_filled_rect(obstacles[i].x, obstacles[i].gap_y + current_gap_height, obstacles[i].x + OBSTACLE_WIDTH, VISIBLE_HEIGHT, GREEN);
+                RenderScene scene = {
+                    &game.p1, &game.p2, game.obstacles, game.num_obstacles,
+                    cfg.gap_height, cfg.bird_radius, cfg.paused, game.score_p1 + game.score_p2, NULL, 0
+                };
+                Bird flock[POPULATION_SAMPLE];
+                if (pop) {
+                    scene.flock = flock;
+                    scene.flock_size = population_sample(pop, flock, POPULATION_SAMPLE);
                 }
-                
-                if (player1.alive) draw_flappy_bird(P1_X_POS, (int)player1.y, P1_COLOR, current_bird_radius);
-                if (player2.alive) draw_flappy_bird(P2_X_POS, (int)player2.y, P2_COLOR, current_bird_radius);
-                
-                if(is_paused) {
-                    draw_filled_rect(145, 100, 155, 140, WHITE);
-                    draw_filled_rect(165, 100, 175, 140, WHITE);
+                if (!render) {
+                    // Repetição só da lógica do jogo.
+                } else if (page_flip) {
+                    render_scene_dirty(&renderer, &scene, NULL);
+                    if (traced) marks[LATENCY_RENDER] = input_now_ns();
+                    pixbuf_wait_swap(&pixel_buffer);
+                    if (marks_pending) {
+                        pending_marks[LATENCY_BLIT] = input_now_ns();
+                        latency_trace_add(&latency, pending_frame, pending_marks);
+                        marks_pending = 0;
+                    }
+                    present_dirty(&renderer, pixel_buffer.back, pixel_buffer.buffers[pixel_buffer.back]);
+                    pixbuf_request_swap(&pixel_buffer);
+                    if (traced) {
+                        memcpy(pending_marks, marks, sizeof(marks));
+                        pending_frame = frame_stats.frames;
+                        marks_pending = 1;
+                    }
+                } else {
+                    render_scene_dirty(&renderer, &scene, NULL);
+                    if (traced) marks[LATENCY_RENDER] = input_now_ns();
+                    present_dirty(&renderer, 0, tela);
+                    if (traced) {
+                        marks[LATENCY_BLIT] = input_now_ns();
+                        latency_trace_add(&latency, frame_stats.frames, marks);
+                    }
                 }
-                
-                draw_score(score_p1 + score_p2, VISIBLE_WIDTH - 10, 10, WHITE);
-                
-                tela = original_tela_ptr;
-                memcpy((void*)tela, back_buffer, LWIDTH * VISIBLE_HEIGHT * PIXEL_SIZE);
                 update_hex_displays(high_score_p1, high_score_p2);
                 break;
             } 
             case GAME_OVER: {
-                int restart_key_pressed = (current_key_state & 0b0110) && !(prev_key_state & 0b0110);
+                if (marks_pending) { // O último quadro da partida ainda está na fila de troca
+                    pixbuf_wait_swap(&pixel_buffer);
+                    pending_marks[LATENCY_BLIT] = input_now_ns();
+                    latency_trace_add(&latency, pending_frame, pending_marks);
+                    marks_pending = 0;
+                }
+                int restart_key_pressed = (pressed & 0b0110) != 0;
                 if (restart_key_pressed) {
-                    reset_game(&player1, &player2, obstacles, num_obstacles, &score_p1, &score_p2, is_two_player_mode, current_spacing, current_gap_height);
-                    state = GAME_RUNNING;
+                    start_game(&game, pop, &cfg);
+                    if (!replaying) announce_game(&cfg, pop, brain);
                 }
                 break;
             }
         } 
-        prev_key_state = current_key_state;
-        usleep(16666);
+        state_hash = hash_game(state_hash, &game);
+        if (replaying) frame_stats.frames++;
+        else {
+            if (marks_pending && wait_swap_before(&pixel_buffer, &deadline)) {
+                pending_marks[LATENCY_BLIT] = input_now_ns();
+                latency_trace_add(&latency, pending_frame, pending_marks);
+                marks_pending = 0;
+            }
+            physics_steps = wait_next_frame(&deadline, &frame_stats);
+        }
     }
     
-    free(back_buffer);
+    if (replaying) {
+        struct timespec end;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double seconds = timespec_diff_ns(&end, &replay_start) / 1e9;
+        printf("Repetição: %lu quadros (%.1f s de jogo) em %.3f s, %.0f quadros/s\n", frame_stats.frames,
+               frame_stats.frames * FRAME_PERIOD_US / 1e6, seconds, seconds > 0 ? frame_stats.frames / seconds : 0.0);
+    } else {
+        printf("Quadros: %lu | Atrasados: %lu | Passos de recuperação: %lu | Quadros descartados: %lu\n",
+               frame_stats.frames, frame_stats.overruns, frame_stats.catchup_steps, frame_stats.dropped_frames);
+        if (input_sampler.running) {
+            input_sampler_stop(&input_sampler);
+            double seconds = frame_stats.frames * FRAME_PERIOD_US / 1e6;
+            if (irq_path) printf("Interrupções dos KEYs: %lu\n", input_sampler.interrupts);
+            printf("Entrada: leitura a %.0f Hz | %lu apertos, latência média %.2f ms (máx %.2f ms) | "
+                   "%lu toques curtos recuperados | %lu eventos descartados | %lu bordas de repique\n",
+                   seconds > 0 ? input_sampler.samples / seconds : 0.0, input_stats.presses,
+                   input_stats.presses ? input_stats.latency_sum_ns / 1e6 / input_stats.presses : 0.0,
+                   input_stats.latency_max_ns / 1e6, input_stats.taps, input_sampler.dropped,
+                   input_sampler.bounced);
+        }
+        latency_trace_report(&latency, stdout);
+        shadow_outputs_report(&outputs, stdout);
+        latency_trace_close(&latency);
+    }
+    printf("Mudanças de SW aplicadas: %lu\n", config_rebuilds);
+    printf("Recordes: P1 %d, P2 %d | Hash do estado: %08X\n", high_score_p1, high_score_p2, state_hash);
+    input_log_close(&input_log);
+    if (render) dirty_renderer_free(&renderer);
+    if (pop) population_free(pop);
+    free(replay_screen);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,60 @@
+/**
+ * @file flappy.h
+ * @brief Constantes e estruturas do jogo compartilhadas entre o jogo na placa
+ * e as ferramentas de medição em tools/.
+ */
+#ifndef FLAPPY_H
+#define FLAPPY_H
+
+#include "de1soc.h"
+
+#define SPEED_LEVEL_0    2 
+#define SPEED_LEVEL_1    3 
+#define SPEED_LEVEL_2    4 
+#define SPEED_LEVEL_3    5 
+
+#define GAP_EASIEST 100
+#define GAP_EASY     90
+#define GAP_HARD     80
+#define GAP_HARDEST  70
+
+#define NUM_PIPES_EASY 2
+#define NUM_PIPES_HARD 3
+#define SPACING_EASY 220
+#define SPACING_HARD 130 
+
+// Gravidade e pulo em pixels/quadro; a física usa esses valores em Q16.16 (FIX16).
+#define GRAVITY_EASY 0.5
+#define GRAVITY_HARD 0.35
+
+#define JUMP_EASY -5.5
+#define JUMP_HARD -7.0
+
+#define RADIUS_EASY 10
+#define RADIUS_HARD 13
+
+#define P1_X_POS         60
+#define P2_X_POS         90
+#define OBSTACLE_WIDTH   50
+
+#define FRAME_PERIOD_US  16666
+#define FRAME_PERIOD_NS  16666667LL
+#define MAX_CATCHUP_STEPS 4 // Máximo de passos de física por quadro ao recuperar atrasos
+
+/*
+ * Ponto fixo Q16.16: inteiro de 32 bits com 16 bits de fração. A física do
+ * pássaro só faz somas e comparações inteiras, então a trajetória é a mesma,
+ * bit a bit, na placa e no PC, e o Cortex-A9 não usa a VFP por quadro.
+ */
+typedef int32_t fix16;
+#define FIX16_SHIFT       16
+#define FIX16_ONE         (1 << FIX16_SHIFT)
+#define FIX16(d)          ((fix16)((d) * FIX16_ONE + ((d) < 0 ? -0.5 : 0.5))) // Para constantes
+#define FIX16_FROM_INT(i) ((fix16)((i) * FIX16_ONE))
+#define FIX16_TO_INT(f)   ((int)((f) >> FIX16_SHIFT)) // Arredonda para baixo
+
+typedef enum { GAME_RUNNING, GAME_OVER } GameState;
+typedef struct { fix16 y, velocity_y; int alive; } Bird; // Posição e velocidade em Q16.16
+typedef struct { int x, gap_y, scored; } Obstacle;
+
+#endif
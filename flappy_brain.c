@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "flappy_brain.h"
+
+#define GENOME_MAGIC       "FLPG"
+#define GENOME_HEADER_SIZE 12
+
+// Escalas das entradas: deixam cada uma aproximadamente em [-1, 1].
+#define SCALE_Y  FIX16(1.0 / VISIBLE_HEIGHT)
+#define SCALE_X  FIX16(1.0 / VISIBLE_WIDTH)
+#define SCALE_VY FIX16(1.0 / 8)
+
+#define BRAIN_ACTIVATION_MAX FIX16_FROM_INT(1 << 12) // 2^28 em Q16.16
+
+static inline fix16 fix16_mul(fix16 a, fix16 b) {
+    return (fix16)(((int64_t)a * b) >> FIX16_SHIFT);
+}
+
+int brain_jump(const Genome *genome, const Bird *bird, int bird_x, const Game *game, const GameConfig *cfg) {
+    if (!bird->alive) return 0;
+    const Obstacle *next = next_obstacle(game, bird_x, cfg);
+    int gap_top = next ? next->gap_y : 0;
+    int gap_bottom = next ? next->gap_y + cfg->gap_height : VISIBLE_HEIGHT;
+    int dx = next ? next->x + OBSTACLE_WIDTH - bird_x : VISIBLE_WIDTH;
+
+    fix16 in[BRAIN_INPUTS] = {
+        fix16_mul(bird->y - FIX16_FROM_INT(gap_top), SCALE_Y),
+        fix16_mul(FIX16_FROM_INT(gap_bottom) - bird->y, SCALE_Y),
+        fix16_mul(bird->velocity_y, SCALE_VY),
+        fix16_mul(FIX16_FROM_INT(dx), SCALE_X)
+    };
+
+    // Acumula em 64 bits e desloca uma vez por neurônio. O ReLU é limitado a
+    // BRAIN_ACTIVATION_MAX: com pesos quaisquer lidos do arquivo, cada termo da
+    // saída fica abaixo de 2^59 e a soma dos BRAIN_HIDDEN termos cabe em int64.
+    const fix16 *w = genome->w;
+    int64_t out = 0;
+    const fix16 *out_w = w + BRAIN_HIDDEN * (BRAIN_INPUTS + 1);
+    for (int h = 0; h < BRAIN_HIDDEN; h++, w += BRAIN_INPUTS + 1) {
+        int64_t acc = 0;
+        for (int i = 0; i < BRAIN_INPUTS; i++) acc += (int64_t)w[i] * in[i];
+        acc = (acc >> FIX16_SHIFT) + w[BRAIN_INPUTS];
+        if (acc <= 0) continue;
+        if (acc > BRAIN_ACTIVATION_MAX) acc = BRAIN_ACTIVATION_MAX;
+        out += (int64_t)out_w[h] * acc;
+    }
+    out = (out >> FIX16_SHIFT) + out_w[BRAIN_HIDDEN];
+    return out > 0;
+}
+
+static void put_le32(unsigned char *p, uint32_t v) {
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = (v >> 24) & 0xFF;
+}
+
+static uint32_t get_le32(const unsigned char *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+int genome_save(const Genome *genome, const char *path, unsigned int switches, uint32_t fitness) {
+    unsigned char buf[GENOME_HEADER_SIZE + 4 * BRAIN_WEIGHTS];
+    memcpy(buf, GENOME_MAGIC, 4);
+    buf[4] = BRAIN_VERSION;
+    buf[5] = BRAIN_WEIGHTS;
+    buf[6] = switches & 0xFF;
+    buf[7] = (switches >> 8) & 0xFF;
+    put_le32(buf + 8, fitness);
+    for (int i = 0; i < BRAIN_WEIGHTS; i++) put_le32(buf + GENOME_HEADER_SIZE + 4 * i, (uint32_t)genome->w[i]);
+
+    FILE *f = fopen(path, "wb");
+    if (!f) { perror("Erro ao criar o arquivo do genoma"); return -1; }
+    int ok = fwrite(buf, 1, sizeof(buf), f) == sizeof(buf);
+    if (fclose(f) != 0) ok = 0;
+    if (!ok) { perror("Erro ao gravar o genoma"); return -1; }
+    return 0;
+}
+
+int genome_load(Genome *genome, const char *path, unsigned int *switches, uint32_t *fitness) {
+    FILE *f = fopen(path, "rb");
+    if (!f) { perror("Erro ao abrir o arquivo do genoma"); return -1; }
+    unsigned char buf[GENOME_HEADER_SIZE + 4 * BRAIN_WEIGHTS];
+    size_t n = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    if (n != sizeof(buf) || memcmp(buf, GENOME_MAGIC, 4) != 0 || buf[4] != BRAIN_VERSION || buf[5] != BRAIN_WEIGHTS) {
+        fprintf(stderr, "%s não é um genoma válido (versão %d, %d pesos)\n", path, BRAIN_VERSION, BRAIN_WEIGHTS);
+        return -1;
+    }
+    if (switches) *switches = (unsigned int)buf[6] | (unsigned int)buf[7] << 8;
+    if (fitness) *fitness = get_le32(buf + 8);
+    for (int i = 0; i < BRAIN_WEIGHTS; i++) genome->w[i] = (fix16)get_le32(buf + GENOME_HEADER_SIZE + 4 * i);
+    return 0;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file flappy_brain.h
+ * @brief Rede neural pequena que decide quando apertar KEY1, treinada por
+ * tools/flappy_train.c e carregada pelo jogo com --brain <arquivo>.
+ *
+ * Entradas: distância do pássaro às bordas de cima e de baixo da próxima
+ * abertura, velocidade e distância horizontal até o fim do próximo cano.
+ * Uma camada oculta de BRAIN_HIDDEN neurônios ReLU e uma saída: pula se a
+ * saída for positiva. Pesos e contas em Q16.16, como a física, então a rede
+ * toma as mesmas decisões no PC em que foi treinada e na placa.
+ *
+ * Arquivo do genoma (inteiros little-endian): "FLPG", versão (1 byte),
+ * BRAIN_WEIGHTS (1 byte), SW do treino (2 bytes), aptidão (4 bytes) e os
+ * BRAIN_WEIGHTS pesos (4 bytes cada).
+ */
+#ifndef FLAPPY_BRAIN_H
+#define FLAPPY_BRAIN_H
+
+#include <stdint.h>
+
+#include "flappy_core.h"
+
+#define BRAIN_VERSION 1
+#define BRAIN_INPUTS  4
+#define BRAIN_HIDDEN  6
+// Pesos e bias da camada oculta, seguidos dos pesos e bias da saída.
+#define BRAIN_WEIGHTS (BRAIN_HIDDEN * (BRAIN_INPUTS + 1) + BRAIN_HIDDEN + 1)
+
+typedef struct {
+    fix16 w[BRAIN_WEIGHTS];
+} Genome;
+
+/**
+ * @brief Decide se o pássaro em bird_x deve pular neste passo.
+ * @return 1 para pular (equivale a uma borda de subida de KEY1).
+ */
+int brain_jump(const Genome *genome, const Bird *bird, int bird_x, const Game *game, const GameConfig *cfg);
+
+/**
+ * @brief Grava o genoma com a configuração de SW e a aptidão do treino.
+ * @return 0 em caso de sucesso, -1 em caso de falha.
+ */
+int genome_save(const Genome *genome, const char *path, unsigned int switches, uint32_t fitness);
+
+/**
+ * @brief Lê um genoma gravado por genome_save(). switches e fitness podem ser NULL.
+ * @return 0 em caso de sucesso, -1 em caso de falha.
+ */
+int genome_load(Genome *genome, const char *path, unsigned int *switches, uint32_t *fitness);
+
+#endif
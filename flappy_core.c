@@ -0,0 +1,220 @@
+#include "flappy_core.h"
+
+#define DEFAULT_SEED 0x9E3779B9u // xorshift32 não pode ter estado 0
+
+void game_seed(Game *game, uint32_t seed) {
+    game->rng = seed ? seed : DEFAULT_SEED;
+}
+
+static uint32_t game_rand(Game *game) {
+    uint32_t x = game->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    game->rng = x;
+    return x;
+}
+
+/*
+ * Abertura sorteada em [30, VISIBLE_HEIGHT - gap_height - 30). Usa multiplicação
+ * em 64 bits em vez de % porque o Cortex-A9 não tem instrução de divisão inteira.
+ */
+static int random_gap_y(Game *game, const GameConfig *cfg) {
+    return (int)(((uint64_t)game_rand(game) * cfg->gap_range) >> 32) + 30;
+}
+
+void game_config_from_switches(GameConfig *cfg, unsigned int switches) {
+    cfg->switches = switches;
+    if (switches & (1 << 4)) {
+        cfg->num_obstacles = NUM_PIPES_HARD;
+        cfg->spacing = SPACING_HARD;
+    } else {
+        cfg->num_obstacles = NUM_PIPES_EASY;
+        cfg->spacing = SPACING_EASY;
+    }
+
+    switch (switches & 0b11) {
+        case 0b00: cfg->speed = SPEED_LEVEL_0; break;
+        case 0b01: cfg->speed = SPEED_LEVEL_1; break;
+        case 0b10: cfg->speed = SPEED_LEVEL_2; break;
+        case 0b11: cfg->speed = SPEED_LEVEL_3; break;
+    }
+
+    switch ((switches >> 2) & 0b11) {
+        case 0b00: cfg->gap_height = GAP_EASIEST; break;
+        case 0b01: cfg->gap_height = GAP_EASY;    break;
+        case 0b10: cfg->gap_height = GAP_HARD;    break;
+        case 0b11: cfg->gap_height = GAP_HARDEST; break;
+    }
+
+    cfg->gravity = (switches & (1 << 5)) ? FIX16(GRAVITY_HARD) : FIX16(GRAVITY_EASY);
+    cfg->jump_velocity = (switches & (1 << 6)) ? FIX16(JUMP_HARD) : FIX16(JUMP_EASY);
+    cfg->bird_radius = (switches & (1 << 7)) ? RADIUS_HARD : RADIUS_EASY;
+    cfg->two_player = (switches & 0x100) != 0;
+    cfg->paused = (switches & 0x200) != 0;
+    cfg->gap_range = (uint32_t)(VISIBLE_HEIGHT - cfg->gap_height - 60);
+}
+
+int game_config_update(GameConfig *cfg, unsigned int switches) {
+    if (switches == cfg->switches) return 0;
+    game_config_from_switches(cfg, switches);
+    return 1;
+}
+
+void bird_step(Bird *bird, int jump, const GameConfig *cfg) {
+    if (!bird->alive) return;
+    if (jump) bird->velocity_y = cfg->jump_velocity;
+    bird->velocity_y += cfg->gravity;
+    bird->y += bird->velocity_y;
+}
+
+static int hits_border(const Bird *bird, int bird_radius) {
+    return bird->y - FIX16_FROM_INT(bird_radius) < 0 || bird->y + FIX16_FROM_INT(bird_radius) > FIX16_FROM_INT(VISIBLE_HEIGHT);
+}
+
+// Pássaro fora da abertura de um cano que já se sabe estar sob ele.
+static int hits_pipe(const Bird *bird, const Obstacle *obs, int bird_radius, int gap_height) {
+    return bird->y - FIX16_FROM_INT(bird_radius) < FIX16_FROM_INT(obs->gap_y) ||
+           bird->y + FIX16_FROM_INT(bird_radius) > FIX16_FROM_INT(obs->gap_y + gap_height);
+}
+
+int check_collision(const Bird* bird, int bird_x_pos, const Obstacle* obs, int bird_radius, int gap_height) {
+    if (hits_border(bird, bird_radius)) {
+        return 1;
+    }
+    if (bird_x_pos + bird_radius > obs->x && bird_x_pos - bird_radius < obs->x + OBSTACLE_WIDTH) {
+        return hits_pipe(bird, obs, bird_radius, gap_height);
+    }
+    return 0;
+}
+
+int obstacles_under(const Game *game, int bird_x, int bird_radius, const Obstacle *out[MAX_OBSTACLES]) {
+    int n = 0;
+    for (int k = 0; k < game->num_obstacles; k++) {
+        const Obstacle *obs = obstacle_at(game, k);
+        if (obs->x >= bird_x + bird_radius) break; // Este e os seguintes começam depois do pássaro
+        if (bird_x - bird_radius < obs->x + OBSTACLE_WIDTH) out[n++] = obs;
+    }
+    return n;
+}
+
+// Mesmo resultado de check_collision() com cada cano, testando só os que estão sob o pássaro.
+static int bird_collides(const Game *game, const Bird *bird, int bird_x, const GameConfig *cfg) {
+    if (hits_border(bird, cfg->bird_radius)) return 1;
+    const Obstacle *under[MAX_OBSTACLES];
+    int n = obstacles_under(game, bird_x, cfg->bird_radius, under);
+    for (int k = 0; k < n; k++) {
+        if (hits_pipe(bird, under[k], cfg->bird_radius, cfg->gap_height)) return 1;
+    }
+    return 0;
+}
+
+const Obstacle *next_obstacle(const Game *game, int bird_x, const GameConfig *cfg) {
+    for (int k = 0; k < game->num_obstacles; k++) {
+        const Obstacle *obs = obstacle_at(game, k);
+        if (obs->x + OBSTACLE_WIDTH >= bird_x - cfg->bird_radius) return obs;
+    }
+    return NULL;
+}
+
+int next_gap_floor(const Game *game, int bird_x, const GameConfig *cfg) {
+    const Obstacle *next = next_obstacle(game, bird_x, cfg);
+    return next ? next->gap_y + cfg->gap_height : VISIBLE_HEIGHT;
+}
+
+int autopilot_jump(const Bird *bird, int bird_x, const Game *game, const GameConfig *cfg) {
+    if (!bird->alive) return 0;
+    int floor_y = next_gap_floor(game, bird_x, cfg);
+    fix16 next_y = bird->y + bird->velocity_y + cfg->gravity;
+    return next_y + FIX16_FROM_INT(cfg->bird_radius) > FIX16_FROM_INT(floor_y - AUTOPILOT_MARGIN);
+}
+
+void game_reset(Game *game, const GameConfig *cfg) {
+    game->p1.y = FIX16_FROM_INT(VISIBLE_HEIGHT / 2);
+    game->p1.velocity_y = 0;
+    game->p1.alive = 1;
+
+    game->score_p1 = 0;
+    game->score_p2 = 0;
+
+    game->p2.y = FIX16_FROM_INT(VISIBLE_HEIGHT / 2);
+    game->p2.velocity_y = 0;
+    game->p2.alive = cfg->two_player;
+
+    for (int i = 0; i < cfg->num_obstacles; i++) {
+        game->obstacles[i].x = VISIBLE_WIDTH + 150 + i * cfg->spacing;
+        game->obstacles[i].gap_y = random_gap_y(game, cfg);
+        game->obstacles[i].scored = 0;
+    }
+
+    // Canos fora de uso ficam à esquerda da tela, onde não são desenhados.
+    for (int i = cfg->num_obstacles; i < MAX_OBSTACLES; i++) {
+        game->obstacles[i] = (Obstacle){ -OBSTACLE_WIDTH - 10, 0, 0 };
+    }
+    game->num_obstacles = cfg->num_obstacles;
+    game->first_obstacle = 0;
+    game->state = GAME_RUNNING;
+}
+
+/*
+ * SW4 mudou o número de canos: gira o anel para que o cano mais à esquerda
+ * fique em obstacles[0] e acrescenta canos depois do último (ou retira os
+ * últimos), mantendo os canos em uso em obstacles[0..num_obstacles).
+ */
+static void resize_course(Game *game, const GameConfig *cfg) {
+    Obstacle sorted[MAX_OBSTACLES];
+    int n = game->num_obstacles;
+    for (int k = 0; k < n; k++) sorted[k] = *obstacle_at(game, k);
+    for (; n < cfg->num_obstacles; n++) {
+        sorted[n] = (Obstacle){ sorted[n - 1].x + cfg->spacing, random_gap_y(game, cfg), 0 };
+    }
+    n = cfg->num_obstacles;
+    for (int i = 0; i < MAX_OBSTACLES; i++) {
+        game->obstacles[i] = i < n ? sorted[i] : (Obstacle){ -OBSTACLE_WIDTH - 10, 0, 0 };
+    }
+    game->num_obstacles = n;
+    game->first_obstacle = 0;
+}
+
+int course_step(Game *game, const GameConfig *cfg) {
+    if (game->num_obstacles != cfg->num_obstacles) resize_course(game, cfg);
+    Obstacle *obstacles = game->obstacles;
+    int num_obstacles = game->num_obstacles;
+    int passed = 0;
+    for (int i = 0; i < num_obstacles; i++) {
+        obstacles[i].x -= cfg->speed;
+        if (!obstacles[i].scored && obstacles[i].x + OBSTACLE_WIDTH < P1_X_POS) {
+            obstacles[i].scored = 1;
+            passed++;
+        }
+    }
+    // Como o espaçamento é maior que a velocidade, no máximo um cano sai por passo: o da cabeça do anel.
+    Obstacle *first = &obstacles[game->first_obstacle];
+    if (first->x + OBSTACLE_WIDTH < 0) {
+        first->x = obstacle_at(game, num_obstacles - 1)->x + cfg->spacing;
+        first->gap_y = random_gap_y(game, cfg);
+        first->scored = 0;
+        if (++game->first_obstacle == num_obstacles) game->first_obstacle = 0;
+    }
+    return passed;
+}
+
+GameState game_step(Game *game, unsigned int inputs, const GameConfig *cfg) {
+    if (game->state != GAME_RUNNING || cfg->paused) return game->state;
+
+    Bird *player1 = &game->p1, *player2 = &game->p2;
+
+    bird_step(player1, inputs & INPUT_JUMP_P1, cfg);
+    bird_step(player2, inputs & INPUT_JUMP_P2, cfg);
+    int passed = course_step(game, cfg);
+    if (player1->alive) game->score_p1 += passed;
+    if (player2->alive) game->score_p2 += passed;
+    if (player1->alive && bird_collides(game, player1, P1_X_POS, cfg)) player1->alive = 0;
+    if (player2->alive && bird_collides(game, player2, P2_X_POS, cfg)) player2->alive = 0;
+
+    int game_is_over = 0;
+    if (cfg->two_player) { if (!player1->alive && !player2->alive) game_is_over = 1; }
+    else { if (!player1->alive) game_is_over = 1; }
+    if (game_is_over) game->state = GAME_OVER;
+    return game->state;
+}
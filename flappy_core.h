@@ -0,0 +1,122 @@
+/**
+ * @file flappy_core.h
+ * @brief Núcleo da simulação do jogo: física, pontuação, reciclagem dos canos
+ * e colisões, sem acesso a hardware e sem desenho.
+ *
+ * O laço da placa lê KEY/SW, chama game_step() uma vez por passo de física e
+ * desenha o resultado; tools/flappy_headless.c chama o mesmo núcleo sem placa
+ * e sem espera entre quadros.
+ */
+#ifndef FLAPPY_CORE_H
+#define FLAPPY_CORE_H
+
+#include "flappy.h"
+
+#define MAX_OBSTACLES NUM_PIPES_HARD
+
+// Bits de entrada de um passo: borda de subida do botão de pulo de cada jogador.
+#define INPUT_JUMP_P1 0x1
+#define INPUT_JUMP_P2 0x2
+
+#define AUTOPILOT_MARGIN 2 // Folga (px) do piloto automático até a borda de baixo da abertura
+
+// Parâmetros derivados dos switches SW0-SW9.
+typedef struct {
+    unsigned int switches; // Valor de SW de onde os campos abaixo vieram
+    int speed;          // SW0-SW1
+    int gap_height;     // SW2-SW3
+    int num_obstacles;  // SW4
+    int spacing;        // SW4
+    fix16 gravity;      // SW5
+    fix16 jump_velocity; // SW6
+    int bird_radius;    // SW7
+    int two_player;     // SW8
+    int paused;         // SW9
+    uint32_t gap_range; // Posições possíveis de gap_y para o gap_height atual
+} GameConfig;
+
+/*
+ * Estado completo de uma partida. Os canos em uso ocupam obstacles[0..num_obstacles)
+ * e formam um anel em ordem de x a partir de first_obstacle: o cano que sai pela
+ * esquerda volta logo depois do último, sem procurar o maior x.
+ */
+typedef struct {
+    Bird p1, p2;
+    Obstacle obstacles[MAX_OBSTACLES];
+    int num_obstacles;  // Canos em uso (segue cfg->num_obstacles a cada passo)
+    int first_obstacle; // Índice do cano mais à esquerda
+    int score_p1, score_p2;
+    GameState state;
+    uint32_t rng; // Estado do xorshift32 que sorteia as aberturas dos canos
+} Game;
+
+// Decodifica o valor dos switches (SW0-SW9) em parâmetros do jogo.
+void game_config_from_switches(GameConfig *cfg, unsigned int switches);
+
+/**
+ * @brief Decodifica os switches só se mudaram desde a última decodificação de
+ * cfg (que já deve ter passado por game_config_from_switches()).
+ * @return 1 se cfg foi refeito, 0 se continua igual.
+ */
+int game_config_update(GameConfig *cfg, unsigned int switches);
+
+/**
+ * @brief Inicia o gerador de aberturas da partida. Com a mesma semente (e as
+ * mesmas entradas) a sequência de canos se repete; partidas seguintes continuam
+ * a sequência em vez de voltar ao início.
+ */
+void game_seed(Game *game, uint32_t seed);
+
+// Começa uma partida nova: pássaros no centro, placar zerado e canos fora da tela.
+void game_reset(Game *game, const GameConfig *cfg);
+
+/**
+ * @brief Avança a partida em um passo de física.
+ * Não faz nada com o jogo pausado (cfg->paused) ou já terminado.
+ * @param inputs Combinação de INPUT_JUMP_P1 e INPUT_JUMP_P2.
+ * @return O estado da partida depois do passo.
+ */
+GameState game_step(Game *game, unsigned int inputs, const GameConfig *cfg);
+
+// Aplica o pulo (se houver), a gravidade e a velocidade a um pássaro vivo.
+void bird_step(Bird *bird, int jump, const GameConfig *cfg);
+
+/**
+ * @brief Move os canos um passo e recicla o que saiu da tela. Se SW4 mudou o
+ * número de canos, acrescenta um cano depois do último ou retira o último.
+ * @return Quantos canos passaram de P1_X_POS neste passo (pontos para quem está vivo).
+ */
+int course_step(Game *game, const GameConfig *cfg);
+
+// k-ésimo cano em ordem de x (0 é o mais à esquerda), para k < game->num_obstacles.
+static inline const Obstacle *obstacle_at(const Game *game, int k) {
+    int i = game->first_obstacle + k;
+    return &game->obstacles[i >= game->num_obstacles ? i - game->num_obstacles : i];
+}
+
+/**
+ * @brief Fase ampla das colisões: percorre o anel a partir da esquerda e para
+ * no primeiro cano que começa depois do pássaro, então o custo não cresce com
+ * o número de canos.
+ * @param out Recebe os canos que encostam horizontalmente no pássaro em bird_x.
+ * @return Quantos canos foram escritos em `out`.
+ */
+int obstacles_under(const Game *game, int bird_x, int bird_radius, const Obstacle *out[MAX_OBSTACLES]);
+
+// Cano mais à esquerda que ainda não passou do pássaro em bird_x (NULL se não houver).
+const Obstacle *next_obstacle(const Game *game, int bird_x, const GameConfig *cfg);
+
+// Borda de baixo (px) da abertura de next_obstacle(), ou VISIBLE_HEIGHT se não houver.
+int next_gap_floor(const Game *game, int bird_x, const GameConfig *cfg);
+
+/**
+ * @brief Piloto automático de referência: pula no último passo antes de o
+ * pássaro passar da borda de baixo da abertura do próximo cano que ainda não
+ * ficou para trás. Usado pelas ferramentas de simulação em tools/.
+ * @return 1 se o pássaro deve pular neste passo.
+ */
+int autopilot_jump(const Bird *bird, int bird_x, const Game *game, const GameConfig *cfg);
+
+int check_collision(const Bird *bird, int bird_x_pos, const Obstacle *obs, int bird_radius, int gap_height);
+
+#endif
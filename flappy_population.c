@@ -0,0 +1,217 @@
+#define _DEFAULT_SOURCE
+#include <stdlib.h>
+#include <string.h>
+
+#include "flappy_population.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Parâmetros de um passo, iguais para todos os pássaros.
+typedef struct {
+    fix16 gravity, jump_velocity;
+    fix16 jump_limit; // Pula se y + v + g + margem passar disso (borda de baixo - raio)
+    fix16 lo, hi;     // Intervalo de y sem colisão com as bordas e os canos
+    int32_t passed;
+} StepParams;
+
+static void *alloc_lanes(int capacity) {
+    void *p = NULL;
+    if (posix_memalign(&p, POPULATION_ALIGN, (size_t)capacity * sizeof(int32_t)) != 0) return NULL;
+    memset(p, 0, (size_t)capacity * sizeof(int32_t));
+    return p;
+}
+
+int population_init(BirdPopulation *pop, int count) {
+    memset(pop, 0, sizeof(*pop));
+    if (count <= 0) return -1;
+    pop->count = count;
+    pop->capacity = (count + POPULATION_LANES - 1) / POPULATION_LANES * POPULATION_LANES;
+    pop->y = alloc_lanes(pop->capacity);
+    pop->velocity_y = alloc_lanes(pop->capacity);
+    pop->margin = alloc_lanes(pop->capacity);
+    pop->alive = alloc_lanes(pop->capacity);
+    pop->score = alloc_lanes(pop->capacity);
+    if (!pop->y || !pop->velocity_y || !pop->margin || !pop->alive || !pop->score) {
+        population_free(pop);
+        return -1;
+    }
+    return 0;
+}
+
+void population_free(BirdPopulation *pop) {
+    free(pop->y);
+    free(pop->velocity_y);
+    free(pop->margin);
+    free(pop->alive);
+    free(pop->score);
+    memset(pop, 0, sizeof(*pop));
+}
+
+void population_reset(BirdPopulation *pop, const GameConfig *cfg, uint32_t seed) {
+    uint32_t rng = seed ? seed : 1;
+    fix16 max_margin = FIX16_FROM_INT(cfg->gap_height / 2);
+    for (int i = 0; i < pop->capacity; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        pop->y[i] = FIX16_FROM_INT(VISIBLE_HEIGHT / 2);
+        pop->velocity_y[i] = 0;
+        pop->margin[i] = (fix16)(((uint64_t)rng * (uint32_t)max_margin) >> 32);
+        pop->alive[i] = i < pop->count ? -1 : 0;
+        pop->score[i] = 0;
+    }
+    pop->alive_count = pop->count;
+    pop->passed = 0;
+}
+
+/*
+ * Mesma sequência de autopilot_jump(), bird_step() e check_collision() para um
+ * pássaro, sem desvios: o pulo, a integração e a morte viram máscaras. Pássaros
+ * mortos ficam parados porque a gravidade e a velocidade são somadas com & vivo.
+ */
+static int step_lanes(BirdPopulation *pop, const StepParams *p) {
+    fix16 *y = pop->y, *v = pop->velocity_y;
+    const fix16 *m = pop->margin;
+    int32_t *alive = pop->alive, *score = pop->score;
+    int n = pop->capacity;
+    int i = 0;
+    int32_t alive_count = 0;
+#if defined(__ARM_NEON)
+    int32x4_t g = vdupq_n_s32(p->gravity), jv = vdupq_n_s32(p->jump_velocity);
+    int32x4_t limit = vdupq_n_s32(p->jump_limit), lo = vdupq_n_s32(p->lo), hi = vdupq_n_s32(p->hi);
+    int32x4_t passed = vdupq_n_s32(p->passed), count = vdupq_n_s32(0);
+    for (; i < n; i += 4) {
+        int32x4_t a = vld1q_s32(alive + i), yy = vld1q_s32(y + i), vv = vld1q_s32(v + i);
+        int32x4_t t = vaddq_s32(vaddq_s32(yy, vv), vaddq_s32(g, vld1q_s32(m + i)));
+        uint32x4_t jump = vandq_u32(vreinterpretq_u32_s32(a), vcgtq_s32(t, limit));
+        vv = vbslq_s32(jump, jv, vv);
+        vv = vaddq_s32(vv, vandq_s32(a, g));
+        yy = vaddq_s32(yy, vandq_s32(a, vv));
+        uint32x4_t out = vorrq_u32(vcgtq_s32(lo, yy), vcgtq_s32(yy, hi));
+        uint32x4_t died = vandq_u32(vreinterpretq_u32_s32(a), out);
+        a = vbicq_s32(a, vreinterpretq_s32_u32(out));
+        vst1q_s32(score + i, vbslq_s32(died, passed, vld1q_s32(score + i)));
+        vst1q_s32(y + i, yy);
+        vst1q_s32(v + i, vv);
+        vst1q_s32(alive + i, a);
+        count = vsubq_s32(count, a);
+    }
+    alive_count = vgetq_lane_s32(count, 0) + vgetq_lane_s32(count, 1) + vgetq_lane_s32(count, 2) + vgetq_lane_s32(count, 3);
+#elif defined(__AVX2__)
+    __m256i g = _mm256_set1_epi32(p->gravity), jv = _mm256_set1_epi32(p->jump_velocity);
+    __m256i limit = _mm256_set1_epi32(p->jump_limit), lo = _mm256_set1_epi32(p->lo), hi = _mm256_set1_epi32(p->hi);
+    __m256i passed = _mm256_set1_epi32(p->passed), count = _mm256_setzero_si256();
+    for (; i < n; i += 8) {
+        __m256i a = _mm256_load_si256((const __m256i *)(alive + i));
+        __m256i yy = _mm256_load_si256((const __m256i *)(y + i));
+        __m256i vv = _mm256_load_si256((const __m256i *)(v + i));
+        __m256i t = _mm256_add_epi32(_mm256_add_epi32(yy, vv),
+                                     _mm256_add_epi32(g, _mm256_load_si256((const __m256i *)(m + i))));
+        __m256i jump = _mm256_and_si256(a, _mm256_cmpgt_epi32(t, limit));
+        vv = _mm256_blendv_epi8(vv, jv, jump);
+        vv = _mm256_add_epi32(vv, _mm256_and_si256(a, g));
+        yy = _mm256_add_epi32(yy, _mm256_and_si256(a, vv));
+        __m256i out = _mm256_or_si256(_mm256_cmpgt_epi32(lo, yy), _mm256_cmpgt_epi32(yy, hi));
+        __m256i died = _mm256_and_si256(a, out);
+        a = _mm256_andnot_si256(out, a);
+        __m256i s = _mm256_load_si256((const __m256i *)(score + i));
+        _mm256_store_si256((__m256i *)(score + i), _mm256_blendv_epi8(s, passed, died));
+        _mm256_store_si256((__m256i *)(y + i), yy);
+        _mm256_store_si256((__m256i *)(v + i), vv);
+        _mm256_store_si256((__m256i *)(alive + i), a);
+        count = _mm256_sub_epi32(count, a);
+    }
+    __m128i c = _mm_add_epi32(_mm256_castsi256_si128(count), _mm256_extracti128_si256(count, 1));
+    c = _mm_add_epi32(c, _mm_shuffle_epi32(c, _MM_SHUFFLE(1, 0, 3, 2)));
+    c = _mm_add_epi32(c, _mm_shuffle_epi32(c, _MM_SHUFFLE(2, 3, 0, 1)));
+    alive_count = _mm_cvtsi128_si32(c);
+#elif defined(__SSE2__)
+    __m128i g = _mm_set1_epi32(p->gravity), jv = _mm_set1_epi32(p->jump_velocity);
+    __m128i limit = _mm_set1_epi32(p->jump_limit), lo = _mm_set1_epi32(p->lo), hi = _mm_set1_epi32(p->hi);
+    __m128i passed = _mm_set1_epi32(p->passed), count = _mm_setzero_si128();
+    for (; i < n; i += 4) {
+        __m128i a = _mm_load_si128((const __m128i *)(alive + i));
+        __m128i yy = _mm_load_si128((const __m128i *)(y + i));
+        __m128i vv = _mm_load_si128((const __m128i *)(v + i));
+        __m128i t = _mm_add_epi32(_mm_add_epi32(yy, vv), _mm_add_epi32(g, _mm_load_si128((const __m128i *)(m + i))));
+        __m128i jump = _mm_and_si128(a, _mm_cmpgt_epi32(t, limit));
+        vv = _mm_or_si128(_mm_and_si128(jump, jv), _mm_andnot_si128(jump, vv));
+        vv = _mm_add_epi32(vv, _mm_and_si128(a, g));
+        yy = _mm_add_epi32(yy, _mm_and_si128(a, vv));
+        __m128i out = _mm_or_si128(_mm_cmpgt_epi32(lo, yy), _mm_cmpgt_epi32(yy, hi));
+        __m128i died = _mm_and_si128(a, out);
+        a = _mm_andnot_si128(out, a);
+        __m128i s = _mm_load_si128((const __m128i *)(score + i));
+        _mm_store_si128((__m128i *)(score + i), _mm_or_si128(_mm_and_si128(died, passed), _mm_andnot_si128(died, s)));
+        _mm_store_si128((__m128i *)(y + i), yy);
+        _mm_store_si128((__m128i *)(v + i), vv);
+        _mm_store_si128((__m128i *)(alive + i), a);
+        count = _mm_sub_epi32(count, a);
+    }
+    __m128i c = _mm_add_epi32(count, _mm_shuffle_epi32(count, _MM_SHUFFLE(1, 0, 3, 2)));
+    c = _mm_add_epi32(c, _mm_shuffle_epi32(c, _MM_SHUFFLE(2, 3, 0, 1)));
+    alive_count = _mm_cvtsi128_si32(c);
+#else
+    for (; i < n; i++) {
+        int32_t a = alive[i];
+        int32_t jump = a & -(y[i] + v[i] + p->gravity + m[i] > p->jump_limit);
+        v[i] = (jump & p->jump_velocity) | (~jump & v[i]);
+        v[i] += a & p->gravity;
+        y[i] += a & v[i];
+        int32_t out = -(y[i] < p->lo || y[i] > p->hi);
+        int32_t died = a & out;
+        score[i] = (died & p->passed) | (~died & score[i]);
+        alive[i] = a & ~out;
+        alive_count -= alive[i];
+    }
+#endif
+    return alive_count;
+}
+
+int population_step(BirdPopulation *pop, Game *course, const GameConfig *cfg) {
+    if (course->state != GAME_RUNNING || cfg->paused) return pop->alive_count;
+
+    StepParams p;
+    fix16 r = FIX16_FROM_INT(cfg->bird_radius);
+    // O piloto automático decide com os canos antes do passo, como em autopilot_jump().
+    p.jump_limit = FIX16_FROM_INT(next_gap_floor(course, P1_X_POS, cfg)) - r;
+    p.gravity = cfg->gravity;
+    p.jump_velocity = cfg->jump_velocity;
+    pop->passed += course_step(course, cfg);
+    p.passed = pop->passed;
+
+    // check_collision() de todos os canos combinado em um intervalo: y - r >= borda de cima, y + r <= borda de baixo.
+    p.lo = r;
+    p.hi = FIX16_FROM_INT(VISIBLE_HEIGHT) - r;
+    const Obstacle *under[MAX_OBSTACLES];
+    int n = obstacles_under(course, P1_X_POS, cfg->bird_radius, under);
+    for (int k = 0; k < n; k++) {
+        fix16 top = FIX16_FROM_INT(under[k]->gap_y) + r;
+        fix16 bottom = FIX16_FROM_INT(under[k]->gap_y + cfg->gap_height) - r;
+        if (top > p.lo) p.lo = top;
+        if (bottom < p.hi) p.hi = bottom;
+    }
+
+    pop->alive_count = step_lanes(pop, &p);
+    if (pop->alive_count == 0) course->state = GAME_OVER;
+    return pop->alive_count;
+}
+
+int population_sample(const BirdPopulation *pop, Bird *out, int max) {
+    int n = 0;
+    for (int k = 0; k < max; k++) {
+        // Primeiro pássaro vivo de cada uma das `max` fatias da população.
+        int end = (int)((int64_t)(k + 1) * pop->count / max);
+        for (int i = (int)((int64_t)k * pop->count / max); i < end; i++) {
+            if (pop->alive[i]) {
+                out[n++] = (Bird){ pop->y[i], pop->velocity_y[i], 1 };
+                break;
+            }
+        }
+    }
+    return n;
+}
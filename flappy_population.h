@@ -0,0 +1,69 @@
+/**
+ * @file flappy_population.h
+ * @brief Modo população: milhares de pássaros pilotados automaticamente no
+ * mesmo percurso de canos, guardados como estrutura de vetores (y, velocidade,
+ * vivo) para que a física e as colisões rodem em SIMD (NEON, AVX2 ou SSE2).
+ *
+ * Todos os pássaros estão em P1_X_POS, então em cada passo os canos que
+ * encostam no pássaro são os mesmos para todos: as colisões com os canos e com
+ * as bordas viram um único intervalo [lo, hi] permitido para y. Cada pássaro
+ * tem a sua folga no piloto automático (a mesma regra de autopilot_jump(), com
+ * AUTOPILOT_MARGIN trocado por `margin`), o que dá trajetórias diferentes.
+ */
+#ifndef FLAPPY_POPULATION_H
+#define FLAPPY_POPULATION_H
+
+#include <stdint.h>
+
+#include "flappy_core.h"
+
+#define POPULATION_LANES 8  // Largura do maior vetor (AVX2): a capacidade é múltipla disso
+#define POPULATION_ALIGN 64
+#define POPULATION_SAMPLE 8 // Pássaros desenhados na tela no modo população
+
+typedef struct {
+    int count;        // Pássaros em uso
+    int capacity;     // count arredondado para POPULATION_LANES; as sobras ficam mortas
+    fix16 *y;
+    fix16 *velocity_y;
+    fix16 *margin;    // Folga do piloto automático de cada pássaro
+    int32_t *alive;   // -1 vivo, 0 morto (máscara pronta para as comparações SIMD)
+    int32_t *score;   // Canos passados até morrer (válido só para pássaros mortos)
+    int alive_count;
+    int passed;       // Canos passados desde o início da partida
+} BirdPopulation;
+
+/**
+ * @brief Aloca os vetores de `count` pássaros, alinhados a POPULATION_ALIGN.
+ * @return 0 em caso de sucesso, -1 em caso de falha.
+ */
+int population_init(BirdPopulation *pop, int count);
+void population_free(BirdPopulation *pop);
+
+/**
+ * @brief Coloca todos os pássaros vivos no centro da tela e sorteia as folgas
+ * em [0, gap_height / 2) px com `seed`. A mesma semente dá as mesmas folgas.
+ */
+void population_reset(BirdPopulation *pop, const GameConfig *cfg, uint32_t seed);
+
+/**
+ * @brief Avança a população e os canos de `course` em um passo de física.
+ * Os pássaros de `course` não são usados. Não faz nada com o jogo pausado ou
+ * terminado; quando o último pássaro morre, course->state passa a GAME_OVER.
+ * @return Pássaros vivos depois do passo.
+ */
+int population_step(BirdPopulation *pop, Game *course, const GameConfig *cfg);
+
+// Pontuação do pássaro i: canos passados até morrer, ou até agora se ainda está vivo.
+static inline int population_score(const BirdPopulation *pop, int i) {
+    return pop->alive[i] ? pop->passed : pop->score[i];
+}
+
+/**
+ * @brief Copia até `max` pássaros vivos, espalhados pela população, para
+ * desenhar uma amostra.
+ * @return Quantos pássaros foram copiados.
+ */
+int population_sample(const BirdPopulation *pop, Bird *out, int max);
+
+#endif
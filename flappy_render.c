@@ -0,0 +1,616 @@
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "flappy_render.h"
+
+/*
+ * As primitivas recortam o retângulo ou span contra a área visível uma única
+ * vez e depois escrevem as linhas sem testar cada pixel. Compilando com
+ * -DRENDER_DEBUG, cada span já recortado é conferido com assert.
+ */
+#ifdef RENDER_DEBUG
+#include <assert.h>
+#define ASSERT_SPAN_VISIBLE(x0, x1, y) \
+    assert((y) >= 0 && (y) < VISIBLE_HEIGHT && (x0) >= 0 && (x0) <= (x1) && (x1) <= VISIBLE_WIDTH)
+#else
+#define ASSERT_SPAN_VISIBLE(x0, x1, y) ((void)0)
+#endif
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Cada linha visível tem 640 bytes: múltiplo de 64, então os laços abaixo não têm resto.
+typedef char visible_row_is_64_byte_multiple[(VISIBLE_WIDTH * PIXEL_SIZE) % 64 == 0 ? 1 : -1];
+
+const int font_3x5[10][FONT_HEIGHT][FONT_WIDTH] = {
+    {{1,1,1},{1,0,1},{1,0,1},{1,0,1},{1,1,1}}, {{0,1,0},{1,1,0},{0,1,0},{0,1,0},{1,1,1}}, 
+    {{1,1,1},{0,0,1},{1,1,1},{1,0,0},{1,1,1}}, {{1,1,1},{0,0,1},{0,1,1},{0,0,1},{1,1,1}}, 
+    {{1,0,1},{1,0,1},{1,1,1},{0,0,1},{0,0,1}}, {{1,1,1},{1,0,0},{1,1,1},{0,0,1},{1,1,1}},
+    {{1,1,1},{1,0,0},{1,1,1},{1,0,1},{1,1,1}}, {{1,1,1},{0,0,1},{0,1,0},{0,1,0},{0,1,0}},
+    {{1,1,1},{1,0,1},{1,1,1},{1,0,1},{1,1,1}}, {{1,1,1},{1,0,1},{1,1,1},{0,0,1},{1,1,1}}
+};
+
+volatile uint16_t (*tela)[LWIDTH] = NULL;
+
+const char *const render_phase_names[RENDER_PHASE_COUNT] = {
+    "fill_screen", "pipes", "birds", "score", "present"
+};
+
+void set_pix(int x, int y, uint16_t color) {
+    if (y >= 0 && y < VISIBLE_HEIGHT && x >= 0 && x < VISIBLE_WIDTH) {
+        tela[y][x] = color;
+    }
+}
+
+/**
+ * @brief Recorta o retângulo [x0, x1) x [y0, y1) contra a área visível.
+ * @return 0 se nada do retângulo fica visível.
+ */
+static int clip_rect(int *x0, int *y0, int *x1, int *y1) {
+    if (*x0 < 0) *x0 = 0;
+    if (*y0 < 0) *y0 = 0;
+    if (*x1 > VISIBLE_WIDTH) *x1 = VISIBLE_WIDTH;
+    if (*y1 > VISIBLE_HEIGHT) *y1 = VISIBLE_HEIGHT;
+    return *x0 < *x1 && *y0 < *y1;
+}
+
+void draw_filled_rect(int x0, int y0, int x1, int y1, uint16_t color) {
+    if (!clip_rect(&x0, &y0, &x1, &y1)) return;
+    for (int y = y0; y < y1; y++) {
+        ASSERT_SPAN_VISIBLE(x0, x1, y);
+        volatile uint16_t *row = tela[y];
+        for (int x = x0; x < x1; x++) row[x] = color;
+    }
+}
+
+/*
+ * Tabelas de meia-largura dos círculos: circle_half_width[r][dy] é o maior x
+ * com x*x + dy*dy <= r*r. Cada raio é calculado uma única vez.
+ */
+static int8_t circle_half_width[CIRCLE_TABLE_MAX + 1][CIRCLE_TABLE_MAX + 1];
+static uint8_t circle_table_ready[CIRCLE_TABLE_MAX + 1];
+
+void circle_spans_prepare(int r) {
+    if (r < 0 || r > CIRCLE_TABLE_MAX || circle_table_ready[r]) return;
+    int x = r;
+    for (int dy = 0; dy <= r; dy++) {
+        while (x * x + dy * dy > r * r) x--;
+        circle_half_width[r][dy] = (int8_t)x;
+    }
+    circle_table_ready[r] = 1;
+}
+
+static void draw_hline(int x0, int x1, int y, uint16_t color) {
+    if (y < 0 || y >= VISIBLE_HEIGHT) return;
+    if (x0 < 0) x0 = 0;
+    if (x1 > VISIBLE_WIDTH) x1 = VISIBLE_WIDTH;
+    if (x0 >= x1) return;
+    ASSERT_SPAN_VISIBLE(x0, x1, y);
+    volatile uint16_t *row = tela[y];
+    for (int x = x0; x < x1; x++) row[x] = color;
+}
+
+void draw_circle(int xc, int yc, int r, uint16_t color) {
+    if (r < 0) return;
+    if (r > CIRCLE_TABLE_MAX) {
+        for (int y = -r; y <= r; y++) {
+            int x = 0;
+            while ((x + 1) * (x + 1) + y * y <= r * r) x++;
+            draw_hline(xc - x, xc + x + 1, yc + y, color);
+        }
+        return;
+    }
+    circle_spans_prepare(r);
+    const int8_t *half_width = circle_half_width[r];
+    for (int dy = -r; dy <= r; dy++) {
+        int hw = half_width[dy < 0 ? -dy : dy];
+        draw_hline(xc - hw, xc + hw + 1, yc + dy, color);
+    }
+}
+
+void draw_digit(int digit, int x, int y, uint16_t color) {
+    if (digit < 0 || digit > 9) return;
+    // Dígito inteiro fora da tela: descarta antes de recortar cada célula.
+    if (x >= VISIBLE_WIDTH || y >= VISIBLE_HEIGHT ||
+        x + FONT_WIDTH * FONT_SCALE <= 0 || y + FONT_HEIGHT * FONT_SCALE <= 0) return;
+    for (int row = 0; row < FONT_HEIGHT; row++) {
+        for (int col = 0; col < FONT_WIDTH; col++) {
+            if (font_3x5[digit][row][col] == 1) {
+                draw_filled_rect(x + (col * FONT_SCALE), y + (row * FONT_SCALE),
+                                 x + (col * FONT_SCALE) + FONT_SCALE, y + (row * FONT_SCALE) + FONT_SCALE,
+                                 color);
+            }
+        }
+    }
+}
+
+void draw_score(int score, int x, int y, uint16_t color) {
+    char score_text[10];
+    sprintf(score_text, "%d", score);
+    int len = strlen(score_text);
+    int current_x = x;
+
+    for (int i = len - 1; i >= 0; i--) {
+        int digit = score_text[i] - '0';
+        int char_width = (FONT_WIDTH * FONT_SCALE);
+        current_x -= char_width;
+        draw_digit(digit, current_x, y, color);
+        current_x -= FONT_CHAR_SPACING;
+    }
+}
+
+void fill_screen(uint16_t color) {
+    for (int y = 0; y < VISIBLE_HEIGHT; y++) {
+        for (int x = 0; x < VISIBLE_WIDTH; x++) {
+            tela[y][x] = color;
+        }
+    }
+}
+
+void draw_flappy_bird_shapes(int x, int y, uint16_t body_color, int bird_radius) {
+    draw_circle(x, y, bird_radius, body_color);
+    draw_circle(x + bird_radius / 2, y - bird_radius / 3, bird_radius / 4, WHITE);
+    set_pix(x + bird_radius / 2, y - bird_radius / 3, BLACK);
+    draw_filled_rect(x + bird_radius, y - 2, x + bird_radius + 5, y + 2, BEAK_COLOR);
+    draw_filled_rect(x - bird_radius / 2, y, x, y + 5, WHITE);
+}
+
+/*
+ * Cache de sprites do pássaro. A aparência depende só do raio e da cor do
+ * corpo, então cada variante é desenhada uma vez com as primitivas e guardada
+ * como bitmap RGB565 compacto mais a lista de sequências opacas de cada linha.
+ */
+typedef struct { int16_t x0, x1; } SpriteRun;
+
+typedef struct {
+    int radius;
+    uint16_t color;
+    int width, height;
+    int origin_x, origin_y; // Posição do centro do pássaro dentro do sprite
+    uint16_t *pixels;       // width * height
+    SpriteRun *runs;
+    int *row_first_run;     // height + 1 índices em runs[]
+} BirdSprite;
+
+static BirdSprite sprite_cache[MAX_BIRD_SPRITES];
+static int sprite_count = 0;
+
+static const BirdSprite *bird_sprite_get(int bird_radius, uint16_t color) {
+    for (int i = 0; i < sprite_count; i++) {
+        if (sprite_cache[i].radius == bird_radius && sprite_cache[i].color == color) return &sprite_cache[i];
+    }
+    if (sprite_count == MAX_BIRD_SPRITES || bird_radius < 0 || bird_radius > SPRITE_MAX_RADIUS) return NULL;
+
+    BirdSprite sp;
+    sp.radius = bird_radius;
+    sp.color = color;
+    sp.origin_x = bird_radius;
+    sp.origin_y = bird_radius;
+    sp.width = 2 * bird_radius + 5;
+    sp.height = bird_radius + (bird_radius > 4 ? bird_radius : 4) + 1;
+
+    // Desenha a variante sobre dois fundos diferentes: o pixel é opaco se for igual nos dois.
+    uint16_t *canvas[2] = { alloc_frame(), alloc_frame() };
+    sp.pixels = malloc(sp.width * sp.height * sizeof(uint16_t));
+    sp.runs = malloc(sp.width * sp.height * sizeof(SpriteRun));
+    sp.row_first_run = malloc((sp.height + 1) * sizeof(int));
+    if (!canvas[0] || !canvas[1] || !sp.pixels || !sp.runs || !sp.row_first_run) {
+        free(canvas[0]); free(canvas[1]); free(sp.pixels); free(sp.runs); free(sp.row_first_run);
+        return NULL;
+    }
+    volatile uint16_t (*original_tela_ptr)[LWIDTH] = tela;
+    for (int c = 0; c < 2; c++) {
+        tela = (volatile uint16_t (*)[LWIDTH])canvas[c];
+        fill_screen(c ? 0xFFFF : 0x0000);
+        draw_flappy_bird_shapes(sp.origin_x, sp.origin_y, color, bird_radius);
+    }
+    tela = original_tela_ptr;
+
+    int n = 0;
+    for (int y = 0; y < sp.height; y++) {
+        const uint16_t *a = canvas[0] + y * LWIDTH, *b = canvas[1] + y * LWIDTH;
+        sp.row_first_run[y] = n;
+        int x = 0;
+        while (x < sp.width) {
+            while (x < sp.width && a[x] != b[x]) x++;
+            int start = x;
+            while (x < sp.width && a[x] == b[x]) x++;
+            if (x > start) sp.runs[n++] = (SpriteRun){ (int16_t)start, (int16_t)x };
+        }
+        memcpy(&sp.pixels[y * sp.width], a, sp.width * sizeof(uint16_t));
+    }
+    sp.row_first_run[sp.height] = n;
+    free(canvas[0]);
+    free(canvas[1]);
+
+    sprite_cache[sprite_count] = sp;
+    return &sprite_cache[sprite_count++];
+}
+
+/*
+ * Sprites do último raio preparado: o laço desenha sempre com o raio atual e
+ * não precisa procurar no cache a cada pássaro.
+ */
+static int current_radius = -1;
+static const BirdSprite *current_sprites[3];
+
+void prepare_bird_tables(int bird_radius) {
+    circle_spans_prepare(bird_radius);
+    circle_spans_prepare(bird_radius / 4);
+    current_sprites[0] = bird_sprite_get(bird_radius, P1_COLOR);
+    current_sprites[1] = bird_sprite_get(bird_radius, P2_COLOR);
+    current_sprites[2] = bird_sprite_get(bird_radius, DEAD_COLOR);
+    current_radius = bird_radius;
+}
+
+static const BirdSprite *current_sprite(int bird_radius, uint16_t color) {
+    if (bird_radius == current_radius) {
+        for (int i = 0; i < 3; i++) {
+            if (current_sprites[i] && current_sprites[i]->color == color) return current_sprites[i];
+        }
+    }
+    return bird_sprite_get(bird_radius, color);
+}
+
+void draw_flappy_bird(int x, int y, uint16_t body_color, int bird_radius) {
+    const BirdSprite *sp = current_sprite(bird_radius, body_color);
+    if (!sp) {
+        draw_flappy_bird_shapes(x, y, body_color, bird_radius);
+        return;
+    }
+
+    // Recorte calculado uma vez para o sprite inteiro.
+    int left = x - sp->origin_x, top = y - sp->origin_y;
+    int cx0 = left < 0 ? -left : 0;
+    int cx1 = left + sp->width > VISIBLE_WIDTH ? VISIBLE_WIDTH - left : sp->width;
+    int cy0 = top < 0 ? -top : 0;
+    int cy1 = top + sp->height > VISIBLE_HEIGHT ? VISIBLE_HEIGHT - top : sp->height;
+    if (cx0 >= cx1 || cy0 >= cy1) return;
+
+    for (int sy = cy0; sy < cy1; sy++) {
+        ASSERT_SPAN_VISIBLE(left + cx0, left + cx1, top + sy);
+        volatile uint16_t *row = tela[top + sy];
+        const uint16_t *src = &sp->pixels[sy * sp->width];
+        for (int i = sp->row_first_run[sy]; i < sp->row_first_run[sy + 1]; i++) {
+            int x0 = sp->runs[i].x0 < cx0 ? cx0 : sp->runs[i].x0;
+            int x1 = sp->runs[i].x1 > cx1 ? cx1 : sp->runs[i].x1;
+            for (int sx = x0; sx < x1; sx++) row[left + sx] = src[sx];
+        }
+    }
+}
+
+uint16_t *alloc_frame(void) {
+    void *frame = NULL;
+    if (posix_memalign(&frame, FRAME_ALIGN, FRAME_SIZE) != 0) return NULL;
+    return frame;
+}
+
+/**
+ * @brief Copia os 320 pixels visíveis de uma linha com os maiores stores alinhados disponíveis.
+ */
+static inline void blit_row(uint16_t *dst, const uint16_t *src) {
+#if defined(__ARM_NEON)
+    for (int x = 0; x < VISIBLE_WIDTH; x += 32) {
+        uint16x8_t a = vld1q_u16(src + x), b = vld1q_u16(src + x + 8);
+        uint16x8_t c = vld1q_u16(src + x + 16), d = vld1q_u16(src + x + 24);
+        vst1q_u16(dst + x, a);
+        vst1q_u16(dst + x + 8, b);
+        vst1q_u16(dst + x + 16, c);
+        vst1q_u16(dst + x + 24, d);
+    }
+#elif defined(__AVX__)
+    for (int x = 0; x < VISIBLE_WIDTH; x += 32) {
+        __m256i a = _mm256_load_si256((const __m256i *)(src + x));
+        __m256i b = _mm256_load_si256((const __m256i *)(src + x + 16));
+        _mm256_store_si256((__m256i *)(dst + x), a);
+        _mm256_store_si256((__m256i *)(dst + x + 16), b);
+    }
+#elif defined(__SSE2__)
+    for (int x = 0; x < VISIBLE_WIDTH; x += 32) {
+        __m128i a = _mm_load_si128((const __m128i *)(src + x));
+        __m128i b = _mm_load_si128((const __m128i *)(src + x + 8));
+        __m128i c = _mm_load_si128((const __m128i *)(src + x + 16));
+        __m128i d = _mm_load_si128((const __m128i *)(src + x + 24));
+        _mm_store_si128((__m128i *)(dst + x), a);
+        _mm_store_si128((__m128i *)(dst + x + 8), b);
+        _mm_store_si128((__m128i *)(dst + x + 16), c);
+        _mm_store_si128((__m128i *)(dst + x + 24), d);
+    }
+#else
+    memcpy(dst, src, VISIBLE_WIDTH * PIXEL_SIZE);
+#endif
+}
+
+void blit_visible(volatile uint16_t (*dst)[LWIDTH], const uint16_t *src) {
+    for (int y = 0; y < VISIBLE_HEIGHT; y++) {
+        blit_row((uint16_t *)dst[y], src + y * LWIDTH);
+    }
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void end_phase(uint64_t phase_ns[], RenderPhase phase, uint64_t *t0) {
+    if (!phase_ns) return;
+    uint64_t t1 = now_ns();
+    phase_ns[phase] = t1 - *t0;
+    *t0 = t1;
+}
+
+void render_frame(const RenderScene *scene, uint16_t *back_buffer, uint64_t phase_ns[RENDER_PHASE_COUNT]) {
+    uint64_t t0 = phase_ns ? now_ns() : 0;
+
+    volatile uint16_t (*original_tela_ptr)[LWIDTH] = tela;
+    tela = (volatile uint16_t (*)[LWIDTH])back_buffer;
+
+    fill_screen(SKY_BLUE);
+    end_phase(phase_ns, RENDER_PHASE_CLEAR, &t0);
+
+    for (int i = 0; i < scene->num_obstacles; i++) {
+        const Obstacle *obs = &scene->obstacles[i];
+        draw_filled_rect(obs->x, 0, obs->x + OBSTACLE_WIDTH, obs->gap_y, GREEN);
+        draw_filled_rect(obs->x, obs->gap_y + scene->gap_height, obs->x + OBSTACLE_WIDTH, VISIBLE_HEIGHT, GREEN);
+    }
+    end_phase(phase_ns, RENDER_PHASE_PIPES, &t0);
+
+    if (scene->p1->alive) draw_flappy_bird(P1_X_POS, FIX16_TO_INT(scene->p1->y), P1_COLOR, scene->bird_radius);
+    if (scene->p2->alive) draw_flappy_bird(P2_X_POS, FIX16_TO_INT(scene->p2->y), P2_COLOR, scene->bird_radius);
+    for (int i = 0; i < scene->flock_size; i++) {
+        draw_flappy_bird(P1_X_POS, FIX16_TO_INT(scene->flock[i].y), P1_COLOR, scene->bird_radius);
+    }
+    end_phase(phase_ns, RENDER_PHASE_BIRDS, &t0);
+
+    if (scene->is_paused) {
+        draw_filled_rect(145, 100, 155, 140, WHITE);
+        draw_filled_rect(165, 100, 175, 140, WHITE);
+    }
+    draw_score(scene->score, VISIBLE_WIDTH - 10, 10, WHITE);
+    end_phase(phase_ns, RENDER_PHASE_SCORE, &t0);
+
+    tela = original_tela_ptr;
+    blit_visible(tela, back_buffer);
+    end_phase(phase_ns, RENDER_PHASE_PRESENT, &t0);
+}
+
+static void damage_add(DamageList *list, int x0, int y0, int x1, int y1) {
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > VISIBLE_WIDTH) x1 = VISIBLE_WIDTH;
+    if (y1 > VISIBLE_HEIGHT) y1 = VISIBLE_HEIGHT;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    if (list->count == MAX_DAMAGE_RECTS) {
+        // Lista cheia: o último retângulo passa a cobrir a tela inteira.
+        list->rects[MAX_DAMAGE_RECTS - 1] = (Rect){ 0, 0, VISIBLE_WIDTH, VISIBLE_HEIGHT };
+        return;
+    }
+    list->rects[list->count++] = (Rect){ x0, y0, x1, y1 };
+}
+
+static void damage_add_bird(DamageList *list, int x, int y, int r) {
+    int y1 = y + r + 1 > y + 5 ? y + r + 1 : y + 5;
+    damage_add(list, x - r, y - r, x + r + 5, y1);
+}
+
+static void damage_add_score(DamageList *list, int score, int x, int y) {
+    char score_text[10];
+    int len = sprintf(score_text, "%d", score);
+    int width = len * (FONT_WIDTH * FONT_SCALE + FONT_CHAR_SPACING);
+    damage_add(list, x - width, y, x, y + FONT_HEIGHT * FONT_SCALE);
+}
+
+/**
+ * @brief Escreve em `dst` apenas as sequências de pixels de `r` que diferem da sombra.
+ */
+static uint64_t present_rect(const uint16_t *back_buffer, uint16_t *shadow_frame,
+                             volatile uint16_t (*dst)[LWIDTH], const Rect *r) {
+    uint64_t written = 0;
+    for (int y = r->y0; y < r->y1; y++) {
+        const uint16_t *src = back_buffer + y * LWIDTH;
+        uint16_t *shadow = shadow_frame + y * LWIDTH;
+        int x = r->x0;
+        while (x < r->x1) {
+            while (x < r->x1 && src[x] == shadow[x]) x++;
+            int start = x;
+            while (x < r->x1 && src[x] != shadow[x]) x++;
+            // Trechos curtos e desalinhados: escrita pixel a pixel pelo ponteiro
+            // volatile, sem o memcpy() que poderia ler ou juntar acessos na VGA.
+            for (int i = start; i < x; i++) {
+                dst[y][i] = src[i];
+                shadow[i] = src[i];
+            }
+            written += x - start;
+        }
+    }
+    return written;
+}
+
+int dirty_renderer_init(DirtyRenderer *dr, int num_targets) {
+    memset(dr, 0, sizeof(*dr));
+    if (num_targets < 1 || num_targets > MAX_PRESENT_TARGETS) return -1;
+    dr->num_targets = num_targets;
+    dr->back_buffer = alloc_frame();
+    for (int t = 0; t < num_targets; t++) dr->shadow[t] = alloc_frame();
+    for (int t = 0; t < num_targets; t++) {
+        if (!dr->back_buffer || !dr->shadow[t]) {
+            dirty_renderer_free(dr);
+            return -1;
+        }
+    }
+    dirty_renderer_invalidate(dr);
+    return 0;
+}
+
+void dirty_renderer_free(DirtyRenderer *dr) {
+    free(dr->back_buffer);
+    dr->back_buffer = NULL;
+    for (int t = 0; t < MAX_PRESENT_TARGETS; t++) {
+        free(dr->shadow[t]);
+        dr->shadow[t] = NULL;
+    }
+}
+
+void dirty_renderer_invalidate(DirtyRenderer *dr) {
+    dr->full_redraw = 1;
+    for (int t = 0; t < dr->num_targets; t++) dr->target_stale[t] = 1;
+}
+
+/**
+ * @brief Pinta a parte do cano `p` que cai dentro de [x0, x1) x [y0, y1).
+ */
+static void draw_pipe_part(const PipeCache *p, int x0, int x1, int y0, int y1, uint16_t color) {
+    if (x0 < p->x) x0 = p->x;
+    if (x1 > p->x + OBSTACLE_WIDTH) x1 = p->x + OBSTACLE_WIDTH;
+    if (x0 >= x1) return;
+    int bottom_y = p->gap_y + p->gap_height;
+    draw_filled_rect(x0, y0, x1, y1 < p->gap_y ? y1 : p->gap_y, color);
+    draw_filled_rect(x0, y0 > bottom_y ? y0 : bottom_y, x1, y1, color);
+}
+
+// O cano só andou para a esquerda menos que a própria largura, com a mesma abertura.
+static int pipe_scrolled(const PipeCache *old, const PipeCache *cur) {
+    int dx = old->x - cur->x;
+    return old->valid && old->gap_y == cur->gap_y && old->gap_height == cur->gap_height &&
+           dx >= 0 && dx < OBSTACLE_WIDTH;
+}
+
+// Volta `r` ao fundo do quadro anterior: céu e os canos que estão no back buffer.
+static void restore_background(const DirtyRenderer *dr, const Rect *r) {
+    draw_filled_rect(r->x0, r->y0, r->x1, r->y1, SKY_BLUE);
+    for (int i = 0; i < MAX_CACHED_PIPES; i++) {
+        if (dr->pipes[i].valid) draw_pipe_part(&dr->pipes[i], r->x0, r->x1, r->y0, r->y1, GREEN);
+    }
+}
+
+/**
+ * @brief Leva os canos do back buffer até as posições da cena. Primeiro apaga
+ * as colunas que cada cano deixou; se canos se sobrepõem (a troca do número de
+ * canos pode causar isso), essas colunas também podem ter apagado parte de
+ * outro cano e por isso são repintadas. Depois pinta as colunas que entraram.
+ */
+static void update_pipes(DirtyRenderer *dr, const RenderScene *scene, DamageList *cur) {
+    int n = scene->num_obstacles < MAX_CACHED_PIPES ? scene->num_obstacles : MAX_CACHED_PIPES;
+    PipeCache next[MAX_CACHED_PIPES];
+    for (int i = 0; i < MAX_CACHED_PIPES; i++) {
+        next[i] = (PipeCache){ 0, 0, 0, 0 };
+        if (i < n) next[i] = (PipeCache){ scene->obstacles[i].x, scene->obstacles[i].gap_y, scene->gap_height, 1 };
+    }
+
+    Rect erased[MAX_CACHED_PIPES];
+    int num_erased = 0;
+    for (int i = 0; i < MAX_CACHED_PIPES; i++) {
+        const PipeCache *old = &dr->pipes[i];
+        if (!old->valid) continue;
+        int x0 = old->x, x1 = old->x + OBSTACLE_WIDTH;
+        if (next[i].valid && pipe_scrolled(old, &next[i])) {
+            // Só as colunas da direita que o cano deixou para trás.
+            if (next[i].x + OBSTACLE_WIDTH > x0) x0 = next[i].x + OBSTACLE_WIDTH;
+        }
+        if (x0 >= x1) continue;
+        draw_pipe_part(old, x0, x1, 0, VISIBLE_HEIGHT, SKY_BLUE);
+        damage_add(cur, x0, 0, x1, VISIBLE_HEIGHT);
+        erased[num_erased++] = (Rect){ x0, 0, x1, VISIBLE_HEIGHT };
+    }
+
+    for (int i = 0; i < n; i++) {
+        for (int e = 0; e < num_erased; e++) {
+            draw_pipe_part(&next[i], erased[e].x0, erased[e].x1, 0, VISIBLE_HEIGHT, GREEN);
+        }
+        int x0 = next[i].x, x1 = next[i].x + OBSTACLE_WIDTH;
+        if (pipe_scrolled(&dr->pipes[i], &next[i])) {
+            // Só as colunas da esquerda que entraram.
+            if (dr->pipes[i].x < x1) x1 = dr->pipes[i].x;
+        }
+        if (x0 < x1) {
+            draw_pipe_part(&next[i], x0, x1, 0, VISIBLE_HEIGHT, GREEN);
+            damage_add(cur, x0, 0, x1, VISIBLE_HEIGHT);
+        }
+    }
+    for (int i = 0; i < MAX_CACHED_PIPES; i++) dr->pipes[i] = next[i];
+}
+
+void render_scene_dirty(DirtyRenderer *dr, const RenderScene *scene, uint64_t phase_ns[RENDER_PHASE_COUNT]) {
+    uint64_t t0 = phase_ns ? now_ns() : 0;
+
+    volatile uint16_t (*original_tela_ptr)[LWIDTH] = tela;
+    tela = (volatile uint16_t (*)[LWIDTH])dr->back_buffer;
+
+    for (int k = dr->num_targets; k > 0; k--) dr->damage[k] = dr->damage[k - 1];
+    DamageList *cur = &dr->damage[0];
+    cur->count = 0;
+    if (dr->full_redraw) {
+        fill_screen(SKY_BLUE);
+        for (int i = 0; i < MAX_CACHED_PIPES; i++) dr->pipes[i].valid = 0;
+        dr->full_redraw = 0;
+    } else {
+        for (int i = 0; i < dr->overlay.count; i++) restore_background(dr, &dr->overlay.rects[i]);
+    }
+    dr->overlay.count = 0;
+    end_phase(phase_ns, RENDER_PHASE_CLEAR, &t0);
+
+    update_pipes(dr, scene, cur);
+    end_phase(phase_ns, RENDER_PHASE_PIPES, &t0);
+
+    if (scene->p1->alive) {
+        draw_flappy_bird(P1_X_POS, FIX16_TO_INT(scene->p1->y), P1_COLOR, scene->bird_radius);
+        damage_add_bird(cur, P1_X_POS, FIX16_TO_INT(scene->p1->y), scene->bird_radius);
+        damage_add_bird(&dr->overlay, P1_X_POS, FIX16_TO_INT(scene->p1->y), scene->bird_radius);
+    }
+    if (scene->p2->alive) {
+        draw_flappy_bird(P2_X_POS, FIX16_TO_INT(scene->p2->y), P2_COLOR, scene->bird_radius);
+        damage_add_bird(cur, P2_X_POS, FIX16_TO_INT(scene->p2->y), scene->bird_radius);
+        damage_add_bird(&dr->overlay, P2_X_POS, FIX16_TO_INT(scene->p2->y), scene->bird_radius);
+    }
+    for (int i = 0; i < scene->flock_size; i++) {
+        int y = FIX16_TO_INT(scene->flock[i].y);
+        draw_flappy_bird(P1_X_POS, y, P1_COLOR, scene->bird_radius);
+        damage_add_bird(cur, P1_X_POS, y, scene->bird_radius);
+        damage_add_bird(&dr->overlay, P1_X_POS, y, scene->bird_radius);
+    }
+    end_phase(phase_ns, RENDER_PHASE_BIRDS, &t0);
+
+    if (scene->is_paused) {
+        draw_filled_rect(145, 100, 155, 140, WHITE);
+        draw_filled_rect(165, 100, 175, 140, WHITE);
+        damage_add(cur, 145, 100, 175, 140);
+        damage_add(&dr->overlay, 145, 100, 175, 140);
+    }
+    draw_score(scene->score, VISIBLE_WIDTH - 10, 10, WHITE);
+    damage_add_score(cur, scene->score, VISIBLE_WIDTH - 10, 10);
+    damage_add_score(&dr->overlay, scene->score, VISIBLE_WIDTH - 10, 10);
+    end_phase(phase_ns, RENDER_PHASE_SCORE, &t0);
+
+    tela = original_tela_ptr;
+}
+
+void present_dirty(DirtyRenderer *dr, int target, volatile uint16_t (*dst)[LWIDTH]) {
+    if (dr->target_stale[target]) {
+        blit_visible(dst, dr->back_buffer);
+        blit_visible((volatile uint16_t (*)[LWIDTH])dr->shadow[target], dr->back_buffer);
+        dr->pixels_presented += VISIBLE_WIDTH * VISIBLE_HEIGHT;
+        dr->target_stale[target] = 0;
+        return;
+    }
+    for (int k = 0; k <= dr->num_targets; k++) {
+        for (int i = 0; i < dr->damage[k].count; i++) {
+            dr->pixels_presented += present_rect(dr->back_buffer, dr->shadow[target], dst, &dr->damage[k].rects[i]);
+        }
+    }
+}
+
+void render_frame_dirty(DirtyRenderer *dr, const RenderScene *scene, uint64_t phase_ns[RENDER_PHASE_COUNT]) {
+    render_scene_dirty(dr, scene, phase_ns);
+    uint64_t t0 = phase_ns ? now_ns() : 0;
+    present_dirty(dr, 0, tela);
+    end_phase(phase_ns, RENDER_PHASE_PRESENT, &t0);
+}
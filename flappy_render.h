@@ -0,0 +1,160 @@
+/**
+ * @file flappy_render.h
+ * @brief Primitivas de desenho e sequência de renderização de um quadro.
+ *
+ * Todas as primitivas desenham em `tela`, que aponta para o back buffer
+ * durante a renderização e para o framebuffer da VGA fora dela.
+ */
+#ifndef FLAPPY_RENDER_H
+#define FLAPPY_RENDER_H
+
+#include <stdint.h>
+
+#include "flappy.h"
+
+#define WHITE    0xFFFF
+#define GREEN    0x07E0 
+#define P1_COLOR 0xFFE0
+#define P2_COLOR 0xF800
+#define BEAK_COLOR 0xFC00
+#define DEAD_COLOR 0x8410
+#define SKY_BLUE 0x841F
+#define BLACK    0x0000
+
+#define FONT_WIDTH 3
+#define FONT_HEIGHT 5
+#define FONT_CHAR_SPACING 2 
+#define FONT_SCALE 2        
+
+// Fases de um quadro, na ordem em que são executadas no laço principal.
+typedef enum {
+    RENDER_PHASE_CLEAR,
+    RENDER_PHASE_PIPES,
+    RENDER_PHASE_BIRDS,
+    RENDER_PHASE_SCORE,
+    RENDER_PHASE_PRESENT,
+    RENDER_PHASE_COUNT
+} RenderPhase;
+
+// Tudo o que é desenhado em um quadro do estado GAME_RUNNING.
+typedef struct {
+    const Bird *p1, *p2;
+    const Obstacle *obstacles;
+    int num_obstacles;
+    int gap_height;
+    int bird_radius;
+    int is_paused;
+    int score;
+    const Bird *flock; // Amostra do modo população, desenhada em P1_X_POS (NULL fora dele)
+    int flock_size;
+} RenderScene;
+
+#define MAX_DAMAGE_RECTS 32
+#define FRAME_ALIGN      64
+#define CIRCLE_TABLE_MAX 32 // Maior raio com tabela de spans pré-calculada
+#define SPRITE_MAX_RADIUS 32 // Maior raio de pássaro guardado no cache de sprites
+#define MAX_BIRD_SPRITES  16 // Variantes (raio, cor) no cache
+#define MAX_CACHED_PIPES  8  // Canos acompanhados pelo renderizador incremental
+
+typedef struct { int x0, y0, x1, y1; } Rect;
+typedef struct { Rect rects[MAX_DAMAGE_RECTS]; int count; } DamageList;
+// Cano como está desenhado no back buffer do renderizador incremental.
+typedef struct { int x, gap_y, gap_height, valid; } PipeCache;
+
+#define MAX_PRESENT_TARGETS 2
+
+/**
+ * Renderizador por retângulos sujos: o back buffer é mantido entre quadros,
+ * apenas as áreas ocupadas pelos pássaros, placar e pausa no quadro anterior
+ * são restauradas para o fundo e apenas os pixels que mudaram são enviados ao
+ * framebuffer. Como os canos só rolam para a esquerda, cada um pinta apenas as
+ * colunas que entraram e apaga as que saíram; um cano reciclado ou com outra
+ * abertura é redesenhado inteiro. Cada destino (um só
+ * framebuffer, ou os dois buffers do page flipping) tem uma sombra em RAM com o
+ * que já foi escrito nele. Como o destino `t` recebeu o último quadro há
+ * `num_targets` quadros, as áreas comparadas são as de damage[0..num_targets].
+ */
+typedef struct {
+    uint16_t *back_buffer;
+    uint16_t *shadow[MAX_PRESENT_TARGETS];
+    DamageList damage[MAX_PRESENT_TARGETS + 1]; // damage[k]: retângulos de k quadros atrás
+    int num_targets;
+    int full_redraw;
+    int target_stale[MAX_PRESENT_TARGETS];
+    PipeCache pipes[MAX_CACHED_PIPES]; // Canos presentes no back buffer
+    DamageList overlay;                // Pássaros, placar e pausa do quadro anterior
+    uint64_t pixels_presented;
+} DirtyRenderer;
+
+extern volatile uint16_t (*tela)[LWIDTH];
+extern const char *const render_phase_names[RENDER_PHASE_COUNT];
+
+// Aloca um quadro de FRAME_SIZE bytes alinhado a FRAME_ALIGN (libere com free()).
+uint16_t *alloc_frame(void);
+
+/**
+ * @brief Copia só a área visível (320x240) de `src` para `dst`, pulando as
+ * 192 colunas invisíveis de cada linha. Ambos devem estar alinhados a FRAME_ALIGN.
+ */
+void blit_visible(volatile uint16_t (*dst)[LWIDTH], const uint16_t *src);
+
+// Pixel isolado, com teste de limites. As primitivas abaixo não passam por aqui.
+void set_pix(int x, int y, uint16_t color);
+// Retângulo [x0, x1) x [y0, y1), recortado uma vez contra a área visível.
+void draw_filled_rect(int x0, int y0, int x1, int y1, uint16_t color);
+// Círculo preenchido, desenhado como uma sequência horizontal recortada por linha.
+void draw_circle(int xc, int yc, int r, uint16_t color);
+
+// Calcula (uma vez) a tabela de meia-largura das linhas do círculo de raio r.
+void circle_spans_prepare(int r);
+void draw_digit(int digit, int x, int y, uint16_t color);
+void draw_score(int score, int x, int y, uint16_t color);
+void fill_screen(uint16_t color);
+// Desenha o pássaro a partir do sprite em cache da variante (raio, cor).
+void draw_flappy_bird(int x, int y, uint16_t body_color, int bird_radius);
+
+// Desenha o pássaro com as primitivas (círculos e retângulos); gera os sprites.
+void draw_flappy_bird_shapes(int x, int y, uint16_t body_color, int bird_radius);
+
+/**
+ * @brief Pré-calcula as tabelas de spans do corpo (raio r) e do olho (r / 4) e
+ * os sprites das cores P1_COLOR, P2_COLOR e DEAD_COLOR para esse raio, que
+ * passa a ser o raio atual: chame de novo quando a configuração mudar.
+ */
+void prepare_bird_tables(int bird_radius);
+
+/**
+ * @brief Desenha a cena no back buffer e copia o quadro para o framebuffer.
+ * @param phase_ns Se não for NULL, recebe o tempo gasto em cada fase (ns).
+ */
+void render_frame(const RenderScene *scene, uint16_t *back_buffer, uint64_t phase_ns[RENDER_PHASE_COUNT]);
+
+/**
+ * @param num_targets 1 para um único framebuffer, 2 para page flipping.
+ */
+int dirty_renderer_init(DirtyRenderer *dr, int num_targets);
+void dirty_renderer_free(DirtyRenderer *dr);
+
+// Força o próximo quadro a redesenhar e copiar a tela inteira.
+void dirty_renderer_invalidate(DirtyRenderer *dr);
+
+/**
+ * @brief Desenha a cena no back buffer restaurando só as áreas sujas.
+ * @param phase_ns Se não for NULL, recebe o tempo das fases até RENDER_PHASE_SCORE.
+ */
+void render_scene_dirty(DirtyRenderer *dr, const RenderScene *scene, uint64_t phase_ns[RENDER_PHASE_COUNT]);
+
+/**
+ * @brief Escreve em `dst` (o destino `target`) os pixels que mudaram desde que
+ * ele recebeu o último quadro.
+ */
+void present_dirty(DirtyRenderer *dr, int target, volatile uint16_t (*dst)[LWIDTH]);
+
+/**
+ * @brief Mesma cena de render_frame(): render_scene_dirty() seguido de
+ * present_dirty() em `tela`.
+ * @param phase_ns Se não for NULL, recebe o tempo gasto em cada fase (ns).
+ */
+void render_frame_dirty(DirtyRenderer *dr, const RenderScene *scene, uint64_t phase_ns[RENDER_PHASE_COUNT]);
+
+#endif
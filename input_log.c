@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "input_log.h"
+
+#define LOG_MAGIC       "FLPR"
+#define LOG_HEADER_SIZE 12
+
+#define FRAME_KEYS_MASK   0x0F
+#define FRAME_STEPS_SHIFT 4
+#define FRAME_STEPS_MASK  0x03
+#define FRAME_SW_CHANGED  0x40
+#define FRAME_TAPS        0x80
+
+int input_log_create(InputLog *log, const char *path, uint32_t seed, unsigned int switches) {
+    log->f = fopen(path, "wb");
+    if (!log->f) { perror("Erro ao criar o arquivo de gravação"); return -1; }
+    log->seed = seed;
+    log->switches = switches;
+    log->keys = 0;
+
+    unsigned char header[LOG_HEADER_SIZE] = {
+        LOG_MAGIC[0], LOG_MAGIC[1], LOG_MAGIC[2], LOG_MAGIC[3], INPUT_LOG_VERSION, 0,
+        seed & 0xFF, (seed >> 8) & 0xFF, (seed >> 16) & 0xFF, (seed >> 24) & 0xFF,
+        switches & 0xFF, (switches >> 8) & 0xFF
+    };
+    if (fwrite(header, 1, sizeof(header), log->f) != sizeof(header)) {
+        perror("Erro ao gravar o cabeçalho");
+        input_log_close(log);
+        return -1;
+    }
+    return 0;
+}
+
+int input_log_open(InputLog *log, const char *path) {
+    log->f = fopen(path, "rb");
+    if (!log->f) { perror("Erro ao abrir o arquivo de gravação"); return -1; }
+
+    unsigned char h[LOG_HEADER_SIZE];
+    if (fread(h, 1, sizeof(h), log->f) != sizeof(h) || memcmp(h, LOG_MAGIC, 4) != 0 ||
+        h[4] < INPUT_LOG_MIN_VERSION || h[4] > INPUT_LOG_VERSION) {
+        fprintf(stderr, "%s não é uma gravação válida (versões %d a %d)\n", path, INPUT_LOG_MIN_VERSION, INPUT_LOG_VERSION);
+        input_log_close(log);
+        return -1;
+    }
+    log->seed = (uint32_t)h[6] | (uint32_t)h[7] << 8 | (uint32_t)h[8] << 16 | (uint32_t)h[9] << 24;
+    log->switches = (unsigned int)h[10] | (unsigned int)h[11] << 8;
+    log->keys = 0;
+    return 0;
+}
+
+int input_log_write(InputLog *log, const InputFrame *frame) {
+    unsigned char buf[4];
+    size_t n = 1;
+    buf[0] = (frame->keys & FRAME_KEYS_MASK) | ((frame->physics_steps - 1) & FRAME_STEPS_MASK) << FRAME_STEPS_SHIFT;
+    if (frame->switches != log->switches) {
+        buf[0] |= FRAME_SW_CHANGED;
+        buf[n++] = frame->switches & 0xFF;
+        buf[n++] = (frame->switches >> 8) & 0xFF;
+        log->switches = frame->switches;
+    }
+    if ((frame->pressed & FRAME_KEYS_MASK) != (frame->keys & ~log->keys & FRAME_KEYS_MASK)) {
+        buf[0] |= FRAME_TAPS;
+        buf[n++] = frame->pressed & FRAME_KEYS_MASK;
+    }
+    log->keys = frame->keys;
+    if (fwrite(buf, 1, n, log->f) != n) { perror("Erro ao gravar as entradas"); return -1; }
+    return 0;
+}
+
+int input_log_read(InputLog *log, InputFrame *frame) {
+    int b = fgetc(log->f);
+    if (b == EOF) return 0;
+    if (b & FRAME_SW_CHANGED) {
+        int lo = fgetc(log->f), hi = fgetc(log->f);
+        if (lo == EOF || hi == EOF) return -1;
+        log->switches = (unsigned int)lo | (unsigned int)hi << 8;
+    }
+    frame->keys = b & FRAME_KEYS_MASK;
+    frame->pressed = frame->keys & ~log->keys;
+    if (b & FRAME_TAPS) {
+        int taps = fgetc(log->f);
+        if (taps == EOF) return -1;
+        frame->pressed = taps & FRAME_KEYS_MASK;
+    }
+    log->keys = frame->keys;
+    frame->physics_steps = ((b >> FRAME_STEPS_SHIFT) & FRAME_STEPS_MASK) + 1;
+    frame->switches = log->switches;
+    return 1;
+}
+
+void input_log_close(InputLog *log) {
+    if (log->f) fclose(log->f);
+    log->f = NULL;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file input_log.h
+ * @brief Gravação das entradas de uma partida (KEY, SW e passos de física por
+ * quadro) em um arquivo binário compacto, para repeti-la depois sem a placa.
+ *
+ * Formato (inteiros little-endian):
+ * - Cabeçalho de 12 bytes: "FLPR", versão (1 byte), 1 byte reservado,
+ *   semente dos canos (4 bytes) e SW no início (2 bytes).
+ * - Um byte por quadro: bits 0-3 = KEY3-KEY0, bits 4-5 = passos de física - 1,
+ *   bit 6 = SW mudou; nesse caso seguem 2 bytes com o novo valor de SW.
+ *   bit 7 = os KEYs apertados no quadro não são só as bordas de subida entre o
+ *   nível deste quadro e o do anterior (toque curto visto pela thread de
+ *   entrada); nesse caso segue 1 byte com os KEYs apertados (desde a versão 3).
+ * Uma sessão de 10 minutos (36 mil quadros) ocupa cerca de 36 KB.
+ *
+ * A versão muda quando a simulação muda de um jeito que as mesmas entradas
+ * não reproduzem mais a mesma partida (versão 2: canos em anel, com
+ * espaçamento exato na reciclagem). A versão 3 só acrescenta o bit 7, então
+ * gravações da versão 2 continuam sendo lidas.
+ */
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define INPUT_LOG_VERSION     3
+#define INPUT_LOG_MIN_VERSION 2
+
+// Entradas de um quadro do laço principal.
+typedef struct {
+    unsigned int keys;     // Nível de KEY0-KEY3 no fim do quadro
+    unsigned int pressed;  // KEYs apertados desde o quadro anterior, mesmo que já soltos
+    unsigned int switches; // SW0-SW9
+    int physics_steps;     // 1 a MAX_CATCHUP_STEPS
+} InputFrame;
+
+typedef struct {
+    FILE *f;
+    uint32_t seed;
+    unsigned int switches; // SW do último quadro gravado/lido
+    unsigned int keys;     // KEYs do último quadro gravado/lido
+} InputLog;
+
+/**
+ * @brief Cria o arquivo e grava o cabeçalho.
+ * @return 0 em caso de sucesso, -1 em caso de falha.
+ */
+int input_log_create(InputLog *log, const char *path, uint32_t seed, unsigned int switches);
+
+/**
+ * @brief Abre um arquivo gravado e lê o cabeçalho (semente e SW iniciais).
+ * @return 0 em caso de sucesso, -1 em caso de falha.
+ */
+int input_log_open(InputLog *log, const char *path);
+
+// @return 0 em caso de sucesso, -1 em caso de falha.
+int input_log_write(InputLog *log, const InputFrame *frame);
+
+// @return 1 se leu um quadro, 0 no fim do arquivo, -1 se o arquivo estiver truncado.
+int input_log_read(InputLog *log, InputFrame *frame);
+
+void input_log_close(InputLog *log);
+
+#endif
@@ -0,0 +1,132 @@
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "input_sampler.h"
+
+uint64_t input_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * A thread só escreve `tail` e o laço do jogo só escreve `head`. O evento é
+ * gravado antes de publicar o novo `tail` (release), e o consumidor lê `tail`
+ * (acquire) antes do evento, então a fila não precisa de trava.
+ */
+static void queue_push(InputSampler *s, const KeyEvent *ev) {
+    unsigned int tail = s->tail;
+    unsigned int head = __atomic_load_n(&s->head, __ATOMIC_ACQUIRE);
+    if (tail - head == INPUT_QUEUE_SIZE) {
+        s->dropped++;
+        return;
+    }
+    s->events[tail & (INPUT_QUEUE_SIZE - 1)] = *ev;
+    __atomic_store_n(&s->tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+int input_sampler_pop(InputSampler *s, KeyEvent *ev) {
+    unsigned int head = s->head;
+    if (head == __atomic_load_n(&s->tail, __ATOMIC_ACQUIRE)) return 0;
+    *ev = s->events[head & (INPUT_QUEUE_SIZE - 1)];
+    __atomic_store_n(&s->head, head + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+static void *sampler_thread(void *arg) {
+    InputSampler *s = arg;
+    unsigned int level = s->key_ptr[PIO_DATA] & KEY_MASK;
+    uint64_t locked_until[INPUT_KEYS] = { 0 };
+    unsigned int pending = 0; // Bordas capturadas durante a trava, decididas quando ela acaba
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    while (__atomic_load_n(&s->running, __ATOMIC_ACQUIRE)) {
+        unsigned int raw = s->key_ptr[PIO_DATA] & KEY_MASK;
+        unsigned int edges = keys_take_edges(s->key_ptr);
+        uint64_t now = input_now_ns();
+        s->samples++;
+        // Os apertos vêm da captura de bordas da PIO; o nível só serve para ver
+        // quando o KEY é solto. Uma mudança é aceita na hora, e bordas durante
+        // INPUT_DEBOUNCE_NS ficam pendentes até a trava acabar.
+        unsigned int accepted = level, pressed = 0;
+        for (int k = 0; k < INPUT_KEYS; k++) {
+            unsigned int bit = 1u << k;
+            if (now < locked_until[k]) {
+                pending |= edges & bit;
+                continue;
+            }
+            if (pending & bit) {
+                // Se o KEY foi aceito como solto e está apertado, a borda foi um
+                // segundo toque; senão foi repique, e fica só contada.
+                pending &= ~bit;
+                if ((raw & bit) && !(level & bit)) edges |= bit;
+                else if (!(edges & bit)) s->bounced++;
+            }
+            if (edges & bit) {
+                pressed |= bit;
+                accepted = (accepted & ~bit) | (raw & bit); // Pode já ter sido solto
+            } else if ((raw ^ level) & bit) {
+                accepted ^= bit;
+            } else {
+                continue;
+            }
+            locked_until[k] = now + INPUT_DEBOUNCE_NS;
+        }
+        if (accepted != level || pressed) {
+            level = accepted;
+            KeyEvent ev = { now, level, pressed };
+            queue_push(s, &ev);
+        }
+
+        int idle = s->irq && level == 0 && !pending;
+        for (int k = 0; k < INPUT_KEYS; k++) idle = idle && now >= locked_until[k];
+        if (idle) {
+            int r = hw_irq_wait(s->irq, s->wake_pipe[0], -1);
+            if (r < 0) s->irq = NULL; // Sem a interrupção, segue lendo periodicamente
+            if (r > 0) s->interrupts++;
+            clock_gettime(CLOCK_MONOTONIC, &next);
+            continue;
+        }
+
+        next.tv_nsec += INPUT_SAMPLE_PERIOD_NS;
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) != 0) {}
+    }
+    return NULL;
+}
+
+int input_sampler_start(InputSampler *s, volatile unsigned int *key_ptr, HwIrq *irq) {
+    memset(s, 0, sizeof(*s));
+    s->key_ptr = key_ptr;
+    s->irq = irq;
+    if (pipe(s->wake_pipe) == -1) {
+        perror("Erro ao criar o pipe da thread de entrada");
+        return -1;
+    }
+    s->running = 1;
+    if (pthread_create(&s->thread, NULL, sampler_thread, s) != 0) {
+        perror("Erro ao criar a thread de entrada");
+        s->running = 0;
+        close(s->wake_pipe[0]);
+        close(s->wake_pipe[1]);
+        return -1;
+    }
+    return 0;
+}
+
+void input_sampler_stop(InputSampler *s) {
+    if (!s->running) return;
+    __atomic_store_n(&s->running, 0, __ATOMIC_RELEASE);
+    char c = 0;
+    if (write(s->wake_pipe[1], &c, 1) < 0) perror("Erro ao acordar a thread de entrada");
+    pthread_join(s->thread, NULL);
+    close(s->wake_pipe[0]);
+    close(s->wake_pipe[1]);
+}
@@ -0,0 +1,69 @@
+/**
+ * @file input_sampler.h
+ * @brief Thread que lê os registradores de nível e de captura de bordas dos
+ * KEYs a cada INPUT_SAMPLE_PERIOD_NS, filtra os repiques e entrega os apertos
+ * e mudanças de nível, com o instante em que foram vistos, numa fila sem trava
+ * de um produtor e um consumidor.
+ *
+ * O laço do jogo lê os KEYs uma vez por quadro (~16,7 ms): um toque que começa
+ * e termina entre duas leituras se perde. Com a thread, cada mudança vira um
+ * evento na fila, e o laço esvazia a fila no começo do quadro.
+ *
+ * Com uma interrupção (HwIrq), a thread bloqueia em poll() enquanto nenhum KEY
+ * está apertado e acorda no aperto, sem ler o registrador 2000 vezes por
+ * segundo à toa. Enquanto algum KEY está apertado ou filtrando repiques ela
+ * volta a ler a cada INPUT_SAMPLE_PERIOD_NS, porque a PIO só captura apertos.
+ */
+#ifndef INPUT_SAMPLER_H
+#define INPUT_SAMPLER_H
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include "de1soc.h"
+
+#define INPUT_QUEUE_SIZE       64        // Potência de 2
+#define INPUT_SAMPLE_PERIOD_NS 500000LL  // 2 kHz
+#define INPUT_DEBOUNCE_NS      5000000LL // Depois de mudar, um KEY fica 5 ms sem mudar de novo
+#define INPUT_KEYS             4
+
+// Estado dos KEYs depois de uma mudança aceita.
+typedef struct {
+    uint64_t t_ns;        // CLOCK_MONOTONIC da leitura que viu a mudança
+    unsigned int keys;    // Nível de KEY0-KEY3 já filtrado
+    unsigned int pressed; // KEYs capturados pela PIO nesta leitura
+} KeyEvent;
+
+typedef struct {
+    volatile unsigned int *key_ptr;
+    KeyEvent events[INPUT_QUEUE_SIZE];
+    unsigned int head;  // Próximo a ler: só o consumidor escreve
+    unsigned int tail;  // Próximo a escrever: só a thread escreve
+    unsigned long samples;
+    unsigned long dropped; // Eventos perdidos com a fila cheia
+    unsigned long bounced; // Bordas capturadas na trava que não viraram aperto
+    HwIrq *irq;            // NULL: só leitura periódica
+    unsigned long interrupts;
+    int wake_pipe[2];      // Acorda a thread bloqueada na interrupção para ela terminar
+    int running;
+    pthread_t thread;
+} InputSampler;
+
+uint64_t input_now_ns(void);
+
+/**
+ * @brief Inicia a thread de leitura dos registradores da PIO em `key_ptr`.
+ * Enquanto ela roda, só ela apaga a captura de bordas; apertos antigos devem
+ * ter sido descartados antes com keys_clear_edges().
+ * @param irq Interrupção já aberta com hw_irq_open(), ou NULL.
+ * @return 0 em caso de sucesso, -1 em caso de falha.
+ */
+int input_sampler_start(InputSampler *s, volatile unsigned int *key_ptr, HwIrq *irq);
+
+// Para a thread e espera ela terminar (não faz nada se não estiver rodando).
+void input_sampler_stop(InputSampler *s);
+
+// @return 1 se tirou um evento da fila, 0 se ela está vazia.
+int input_sampler_pop(InputSampler *s, KeyEvent *ev);
+
+#endif
@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "latency_trace.h"
+
+// Já alinhados: "%-8s" contaria os bytes do "í".
+static const char *const mark_names[LATENCY_MARKS] = { "leitura ", "física  ", "desenho ", "envio   " };
+
+// Faixas em potências de 2 a partir de 250 us: cobrem de um aperto visto logo
+// antes do quadro até vários quadros de atraso.
+static const unsigned int bucket_limit_us[LATENCY_BUCKETS - 1] = {
+    250, 500, 1000, 2000, 4000, 8000, 16000, 32000, 64000
+};
+
+int latency_trace_open(LatencyTrace *lt, const char *csv_path) {
+    memset(lt, 0, sizeof(*lt));
+    if (!csv_path) return 0;
+    lt->csv = fopen(csv_path, "w");
+    if (!lt->csv) { perror("Erro ao criar o CSV de latência"); return -1; }
+    fprintf(lt->csv, "event,frame,sample_ns,physics_ns,render_ns,blit_ns\n");
+    return 0;
+}
+
+void latency_trace_add(LatencyTrace *lt, unsigned long frame, const uint64_t t_ns[LATENCY_MARKS]) {
+    uint64_t delay[LATENCY_MARKS];
+    for (int m = 0; m < LATENCY_MARKS; m++) {
+        delay[m] = t_ns[m] - t_ns[LATENCY_SAMPLE];
+        lt->sum_ns[m] += delay[m];
+        if (delay[m] > lt->max_ns[m]) lt->max_ns[m] = delay[m];
+    }
+    int b = 0;
+    while (b < LATENCY_BUCKETS - 1 && delay[LATENCY_BLIT] > bucket_limit_us[b] * 1000ull) b++;
+    lt->histogram[b]++;
+    if (lt->csv) {
+        fprintf(lt->csv, "%lu,%lu,%llu,%llu,%llu,%llu\n", lt->events, frame,
+                (unsigned long long)t_ns[LATENCY_SAMPLE], (unsigned long long)delay[LATENCY_PHYSICS],
+                (unsigned long long)delay[LATENCY_RENDER], (unsigned long long)delay[LATENCY_BLIT]);
+    }
+    lt->events++;
+}
+
+void latency_trace_report(const LatencyTrace *lt, FILE *out) {
+    if (lt->events == 0) {
+        fprintf(out, "Latência: nenhum aperto de KEY1 chegou à tela\n");
+        return;
+    }
+    fprintf(out, "Latência do aperto de KEY1 até a tela (%lu apertos):\n", lt->events);
+    for (int m = LATENCY_PHYSICS; m < LATENCY_MARKS; m++) {
+        fprintf(out, "  %s média %7.2f ms  máx %7.2f ms\n", mark_names[m],
+                lt->sum_ns[m] / 1e6 / lt->events, lt->max_ns[m] / 1e6);
+    }
+    unsigned long peak = 0;
+    for (int b = 0; b < LATENCY_BUCKETS; b++) if (lt->histogram[b] > peak) peak = lt->histogram[b];
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        char label[24];
+        if (b < LATENCY_BUCKETS - 1) snprintf(label, sizeof(label), "<= %.2f ms", bucket_limit_us[b] / 1000.0);
+        else snprintf(label, sizeof(label), " > %.2f ms", bucket_limit_us[b - 1] / 1000.0);
+        int bar = (int)(40 * lt->histogram[b] / peak);
+        fprintf(out, "  %-12s %6lu %.*s\n", label, lt->histogram[b], bar,
+                "########################################");
+    }
+}
+
+void latency_trace_close(LatencyTrace *lt) {
+    if (lt->csv) fclose(lt->csv);
+    lt->csv = NULL;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file latency_trace.h
+ * @brief Medição do atraso entre um aperto de KEY1 que vira pulo e o pássaro
+ * atualizado chegar ao framebuffer, em quatro marcas de tempo por aperto
+ * (com o jogo pausado ou P1 já caído o aperto não é contado):
+ * - leitura: instante em que o aperto foi visto (evento da thread de entrada,
+ *   ou a leitura da captura de bordas no começo do quadro sem ela, e então
+ *   a espera entre o aperto e essa leitura não aparece);
+ * - física: fim dos passos de física do quadro que consumiu o aperto;
+ * - desenho: fim do desenho no back buffer;
+ * - envio: fim da cópia para a VGA, ou troca de buffers concluída com --flip
+ *   (vista consultando o bit S a cada 100 us até o prazo do quadro seguinte;
+ *   se a troca passar desse prazo, a marca sai quando esse quadro desenhar).
+ *
+ * Ao sair, latency_trace_report() mostra média e máximo de cada etapa e um
+ * histograma do atraso total. Com um arquivo CSV, cada aperto vira uma linha
+ * com os atrasos de cada marca em relação à leitura.
+ */
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+typedef enum {
+    LATENCY_SAMPLE,
+    LATENCY_PHYSICS,
+    LATENCY_RENDER,
+    LATENCY_BLIT,
+    LATENCY_MARKS
+} LatencyMark;
+
+// Limites superiores das faixas do histograma, em microssegundos; a última é aberta.
+#define LATENCY_BUCKETS 10
+
+typedef struct {
+    FILE *csv;
+    unsigned long events;
+    uint64_t sum_ns[LATENCY_MARKS];
+    uint64_t max_ns[LATENCY_MARKS];
+    unsigned long histogram[LATENCY_BUCKETS];
+} LatencyTrace;
+
+/**
+ * @brief Zera os contadores e abre o CSV (csv_path pode ser NULL).
+ * @return 0 em caso de sucesso, -1 em caso de falha.
+ */
+int latency_trace_open(LatencyTrace *lt, const char *csv_path);
+
+/**
+ * @brief Registra um aperto com as marcas em CLOCK_MONOTONIC, em ordem.
+ * @param frame Quadro em que o aperto foi consumido (vai para o CSV).
+ */
+void latency_trace_add(LatencyTrace *lt, unsigned long frame, const uint64_t t_ns[LATENCY_MARKS]);
+
+void latency_trace_report(const LatencyTrace *lt, FILE *out);
+
+void latency_trace_close(LatencyTrace *lt);
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ * @file mmio_shadow.h
+ * @brief Cópias em RAM ("sombra") dos registradores de saída da DE1-SoC:
+ * LEDR, HEX3_0 e HEX5_4.
+ *
+ * Cada escrita nesses registradores é uma transação sem cache na ponte
+ * HPS-FPGA. Como o valor escrito quase sempre é o mesmo do quadro ou da volta
+ * anterior (placar, LEDs espelhando SW parados), shadow_write() compara com a
+ * cópia e só escreve quando o valor muda, contando as escritas evitadas.
+ * A sombra vale enquanto só este programa escreve nos registradores.
+ *
+ * É só um cabeçalho para que os programas de other_programs/, compilados um
+ * arquivo por vez, possam usá-la sem mudar a linha de compilação.
+ */
+#ifndef MMIO_SHADOW_H
+#define MMIO_SHADOW_H
+
+#include <stdio.h>
+
+// Offsets a partir de 0xFF200000 (os mesmos de de1soc.h).
+#define SHADOW_LEDR_OFFSET   0x0000
+#define SHADOW_HEX3_0_OFFSET 0x0020
+#define SHADOW_HEX5_4_OFFSET 0x0030
+
+typedef struct {
+    volatile unsigned int *reg;
+    unsigned int value;       // Último valor escrito
+    int valid;                // 0 até a primeira escrita: o conteúdo do registrador é desconhecido
+    unsigned long writes;     // Escritas que chegaram ao registrador
+    unsigned long suppressed; // Escritas evitadas por repetirem o valor
+} ShadowReg;
+
+typedef struct {
+    ShadowReg ledr, hex3_0, hex5_4;
+} ShadowOutputs;
+
+static inline void shadow_init(ShadowReg *s, volatile unsigned int *reg) {
+    s->reg = reg;
+    s->value = 0;
+    s->valid = 0;
+    s->writes = 0;
+    s->suppressed = 0;
+}
+
+/**
+ * @brief Liga as sombras aos registradores de uma janela já mapeada de
+ * 0xFF200000 (base NULL deixa as sombras sem registrador, como na repetição
+ * sem placa: as escritas só atualizam a cópia).
+ */
+static inline void shadow_outputs_init(ShadowOutputs *out, volatile void *base) {
+    shadow_init(&out->ledr, base ? (volatile unsigned int *)((volatile char *)base + SHADOW_LEDR_OFFSET) : NULL);
+    shadow_init(&out->hex3_0, base ? (volatile unsigned int *)((volatile char *)base + SHADOW_HEX3_0_OFFSET) : NULL);
+    shadow_init(&out->hex5_4, base ? (volatile unsigned int *)((volatile char *)base + SHADOW_HEX5_4_OFFSET) : NULL);
+}
+
+// @return 1 se o valor foi escrito no registrador, 0 se a escrita foi evitada.
+static inline int shadow_write(ShadowReg *s, unsigned int value) {
+    if (s->valid && s->value == value) {
+        s->suppressed++;
+        return 0;
+    }
+    s->value = value;
+    s->valid = 1;
+    if (!s->reg) return 0;
+    *s->reg = value;
+    s->writes++;
+    return 1;
+}
+
+static inline unsigned long shadow_outputs_suppressed(const ShadowOutputs *out) {
+    return out->ledr.suppressed + out->hex3_0.suppressed + out->hex5_4.suppressed;
+}
+
+static inline void shadow_outputs_report(const ShadowOutputs *out, FILE *f) {
+    fprintf(f, "Escritas em LEDR/HEX3_0/HEX5_4: %lu/%lu/%lu feitas, %lu/%lu/%lu evitadas\n",
+            out->ledr.writes, out->hex3_0.writes, out->hex5_4.writes,
+            out->ledr.suppressed, out->hex3_0.suppressed, out->hex5_4.suppressed);
+}
+
+#endif
@@ -4,6 +4,8 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 
+#include "../mmio_shadow.h"
+
 // Endereço base para os periféricos de uso geral na DE1-SoC
 #define HW_REGS_BASE 0xFF200000
 // Tamanho da janela de memória a ser mapeada
@@ -19,6 +21,7 @@
 volatile void *virtual_base = NULL;
 volatile unsigned int *led_ptr = NULL;
 volatile unsigned int *switch_ptr = NULL;
+ShadowReg led_shadow; // Cópia do LEDR: só escreve quando as chaves mudam
 int fd = -1; // Descritor de arquivo para /dev/mem
 
 /**
@@ -53,6 +56,7 @@ int init_peripherals() {
     // a partir do ponteiro base mapeado.
     led_ptr = (volatile unsigned int *)(virtual_base + LEDR_OFFSET);
     switch_ptr = (volatile unsigned int *)(virtual_base + SW_OFFSET);
+    shadow_init(&led_shadow, led_ptr);
 
     return 0;
 }
@@ -86,9 +90,13 @@ int main() {
         // O registrador de 32 bits contém o estado das 10 chaves nos 10 bits menos significativos.
         unsigned int switch_value = *switch_ptr;
 
-        // 2. Escrever o valor lido diretamente no registrador dos LEDs.
+        // 2. Escrever o valor lido no registrador dos LEDs, só se mudou desde a
+        // última escrita: cada escrita é uma transação no barramento.
         // O hardware da placa se encarrega de acender os LEDs correspondentes.
-        *led_ptr = switch_value;
+        if (shadow_write(&led_shadow, switch_value)) {
+            printf("SW = 0x%03X | escritas evitadas: %lu\r", switch_value, led_shadow.suppressed);
+            fflush(stdout);
+        }
 
         // 3. Pequena pausa para ser um bom "cidadão" no sistema operacional,
         // evitando o uso de 100% da CPU. 100ms é suficiente.
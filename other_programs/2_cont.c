@@ -4,6 +4,8 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 
+#include "../mmio_shadow.h"
+
 // Endereço base e tamanho da janela de memória dos periféricos
 #define HW_REGS_BASE 0xFF200000
 #define HW_REGS_SPAN 0x00010000
@@ -30,6 +32,7 @@ const unsigned char seven_seg_digits[10] = {
 volatile void *virtual_base = NULL;
 volatile unsigned int *hex3_0_ptr = NULL;
 volatile unsigned int *hex5_4_ptr = NULL;
+ShadowOutputs outputs; // Cópias dos registradores dos displays
 int fd = -1;
 
 /**
@@ -53,6 +56,7 @@ int init_peripherals() {
     // Calcula os endereços virtuais para os registradores dos displays
     hex3_0_ptr = (volatile unsigned int *)(virtual_base + HEX3_0_OFFSET);
     hex5_4_ptr = (volatile unsigned int *)(virtual_base + HEX5_4_OFFSET);
+    shadow_outputs_init(&outputs, virtual_base);
 
     return 0;
 }
@@ -62,8 +66,8 @@ int init_peripherals() {
  */
 void cleanup_peripherals() {
     // Apaga todos os displays ao sair
-    if (hex3_0_ptr) *hex3_0_ptr = 0;
-    if (hex5_4_ptr) *hex5_4_ptr = 0;
+    if (hex3_0_ptr) shadow_write(&outputs.hex3_0, 0);
+    if (hex5_4_ptr) shadow_write(&outputs.hex5_4, 0);
     
     if (virtual_base != NULL) {
         munmap((void *)virtual_base, HW_REGS_SPAN);
@@ -87,7 +91,7 @@ int main() {
     printf("Pressione CTRL+C para sair.\n");
     
     // Apaga os displays HEX5 e HEX4, que não serão usados.
-    *hex5_4_ptr = 0;
+    shadow_write(&outputs.hex5_4, 0);
 
     // Loop principal para a contagem repetir indefinidamente
     while (1) {
@@ -107,10 +111,10 @@ int main() {
 
             // 4. Escrever o valor combinado no registrador que controla HEX0-3.
             // Isso acenderá HEX1 e HEX0 e apagará HEX3 e HEX2 (pois seus bits são 0).
-            *hex3_0_ptr = display_value;
+            shadow_write(&outputs.hex3_0, display_value);
             
             // Exibe o número atual no console também
-            printf("Exibindo: %02d\r", count);
+            printf("Exibindo: %02d | escritas evitadas: %lu\r", count, shadow_outputs_suppressed(&outputs));
             fflush(stdout); // Garante que a saída seja impressa imediatamente
 
             // 5. Pausa para controlar a velocidade da contagem.
@@ -5,11 +5,14 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 
+#include "../mmio_shadow.h"
+
 // Endereços e Offsets dos Periféricos
 #define HW_REGS_BASE 0xFF200000
 #define HW_REGS_SPAN 0x00010000
 #define SW_OFFSET    0x0040 // Chaves (Switches)
 #define KEY_OFFSET   0x0050 // Botões (Push-buttons)
+#define KEY_EDGECAPTURE_OFFSET (KEY_OFFSET + 0xC) // Bit ligado a cada aperto até ser apagado; escrever 1 apaga o bit
 #define HEX3_0_OFFSET 0x0020 // Displays HEX0, 1, 2, 3
 #define HEX5_4_OFFSET 0x0030 // Displays HEX4, 5
 
@@ -36,9 +39,10 @@ const unsigned char hex_seg_digits[16] = {
 // Ponteiros globais para os periféricos
 volatile void *virtual_base = NULL;
 volatile unsigned int *switch_ptr = NULL;
-volatile unsigned int *key_ptr = NULL;
+volatile unsigned int *key_edge_ptr = NULL;
 volatile unsigned int *hex3_0_ptr = NULL;
 volatile unsigned int *hex5_4_ptr = NULL;
+ShadowOutputs outputs; // Cópias dos registradores dos displays
 int fd = -1;
 
 /**
@@ -61,9 +65,11 @@ int init_peripherals() {
 
     // Calcula os endereços virtuais para cada periférico
     switch_ptr = (volatile unsigned int *)(virtual_base + SW_OFFSET);
-    key_ptr = (volatile unsigned int *)(virtual_base + KEY_OFFSET);
+    key_edge_ptr = (volatile unsigned int *)(virtual_base + KEY_EDGECAPTURE_OFFSET);
+    *key_edge_ptr = 0xF; // Descarta apertos anteriores ao programa
     hex3_0_ptr = (volatile unsigned int *)(virtual_base + HEX3_0_OFFSET);
     hex5_4_ptr = (volatile unsigned int *)(virtual_base + HEX5_4_OFFSET);
+    shadow_outputs_init(&outputs, virtual_base);
 
     return 0;
 }
@@ -72,8 +78,8 @@ int init_peripherals() {
  * @brief Libera os recursos ao finalizar o programa.
  */
 void cleanup_peripherals() {
-    if (hex3_0_ptr) *hex3_0_ptr = 0;
-    if (hex5_4_ptr) *hex5_4_ptr = 0;
+    if (hex3_0_ptr) shadow_write(&outputs.hex3_0, 0);
+    if (hex5_4_ptr) shadow_write(&outputs.hex5_4, 0);
     
     if (virtual_base != NULL) {
         munmap((void *)virtual_base, HW_REGS_SPAN);
@@ -94,7 +100,6 @@ int main() {
     // Variáveis de estado da lógica
     int position = 0;   // Posição atual (0-5, para HEX0 a HEX5)
     int direction = 1;  // 1 = Direita (HEX0->5), -1 = Esquerda (HEX5->0)
-    unsigned int prev_key_state = 0; // Para detectar o clique do botão
 
     printf("Iniciado. Use SW0-SW3 para escolher o dígito.\n");
     printf("Pressione KEY0 para inverter o sentido.\n");
@@ -109,37 +114,39 @@ int main() {
         // Converte o dígito lido para o código de 7 segmentos
         unsigned char hex_code = hex_seg_digits[digit_to_display];
 
-        // Lê o estado atual dos botões
-        unsigned int current_key_state = *key_ptr;
+        // Lê e apaga os apertos que a PIO dos botões capturou. O laço dorme
+        // 0,4 s por volta: comparando o nível atual com o anterior, um clique
+        // mais curto que isso se perderia
+        unsigned int pressed = *key_edge_ptr & 0xF;
+        if (pressed) *key_edge_ptr = pressed;
         
         // --- LÓGICA DE CONTROLE ---
 
-        // Detecção de borda para o KEY0: Ação ocorre apenas no momento do clique
-        int key0_pressed_now = (current_key_state & 0b0001);
-        int key0_pressed_before = (prev_key_state & 0b0001);
-
-        if (key0_pressed_now && !key0_pressed_before) {
+        // KEY0: Ação ocorre uma vez por clique
+        if (pressed & 0b0001) {
             direction *= -1; // Inverte a direção
             printf("Direção invertida! Sentido: %s\n", direction == 1 ? "Direita" : "Esquerda");
         }
-        prev_key_state = current_key_state; // Atualiza o estado anterior
 
         // --- ATUALIZAÇÃO DA SAÍDA (DISPLAYS) ---
         
-        // 1. Apaga todos os displays para garantir que apenas um esteja aceso
-        *hex3_0_ptr = 0;
-        *hex5_4_ptr = 0;
-
-        // 2. Acende o display na posição correta
+        // 1. Monta o valor final dos dois registradores, com apenas o display
+        // da posição atual aceso (sem apagar tudo antes, o que piscaria e
+        // custaria uma escrita a mais)
+        unsigned int hex3_0 = 0, hex5_4 = 0;
         switch (position) {
-            case 0: *hex3_0_ptr = hex_code; break;
-            case 1: *hex3_0_ptr = hex_code << 8; break;
-            case 2: *hex3_0_ptr = hex_code << 16; break;
-            case 3: *hex3_0_ptr = hex_code << 24; break;
-            case 4: *hex5_4_ptr = hex_code; break;
-            case 5: *hex5_4_ptr = hex_code << 8; break;
+            case 0: hex3_0 = hex_code; break;
+            case 1: hex3_0 = hex_code << 8; break;
+            case 2: hex3_0 = hex_code << 16; break;
+            case 3: hex3_0 = hex_code << 24; break;
+            case 4: hex5_4 = hex_code; break;
+            case 5: hex5_4 = hex_code << 8; break;
         }
 
+        // 2. Escreve só os registradores que mudaram
+        shadow_write(&outputs.hex3_0, hex3_0);
+        shadow_write(&outputs.hex5_4, hex5_4);
+
         // --- ATUALIZAÇÃO DO ESTADO PARA O PRÓXIMO FRAME ---
 
         // 3. Move para a próxima posição
@@ -154,7 +161,8 @@ int main() {
         }
         
         // Imprime o estado atual no console
-        printf("Dígito: %X | Posição: HEX%d \r", digit_to_display, position);
+        printf("Dígito: %X | Posição: HEX%d | escritas evitadas: %lu \r", digit_to_display, position,
+               shadow_outputs_suppressed(&outputs));
         fflush(stdout);
 
         // Pausa para controlar a velocidade do deslocamento
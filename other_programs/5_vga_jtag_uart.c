@@ -100,52 +100,110 @@ void to_upper(char *str) {
 }
 
 // --- Funções de Desenho ---
+/*
+ * As primitivas recortam suas coordenadas contra a área visível uma única vez
+ * e depois escrevem sem testar cada pixel. Compilando com -DRENDER_DEBUG,
+ * cada escrita sem teste é conferida com assert.
+ */
+#ifdef RENDER_DEBUG
+#include <assert.h>
+#define ASSERT_VISIBLE(x, y) assert((x) >= 0 && (x) < VISIBLE_WIDTH && (y) >= 0 && (y) < VISIBLE_HEIGHT)
+#else
+#define ASSERT_VISIBLE(x, y) ((void)0)
+#endif
+
+static inline int is_visible(int x, int y) {
+    return x >= 0 && x < VISIBLE_WIDTH && y >= 0 && y < VISIBLE_HEIGHT;
+}
+
+// Escrita sem teste de limites: só para coordenadas já recortadas.
+static inline void put_pix(int x, int y) {
+    ASSERT_VISIBLE(x, y);
+    tela[y][x] = current_color;
+}
+
 void set_pix(int x, int y) {
-    if (y < 0 || y >= VISIBLE_HEIGHT || x < 0 || x >= VISIBLE_WIDTH) return;
+    if (!is_visible(x, y)) return;
     tela[y][x] = current_color;
 }
 
+// Linha horizontal de x0 a x1 (inclusive), recortada uma vez.
+static void draw_hline(int x0, int x1, int y) {
+    if (x0 > x1) { int t = x0; x0 = x1; x1 = t; }
+    if (y < 0 || y >= VISIBLE_HEIGHT) return;
+    if (x0 < 0) x0 = 0;
+    if (x1 >= VISIBLE_WIDTH) x1 = VISIBLE_WIDTH - 1;
+    for (int x = x0; x <= x1; x++) put_pix(x, y);
+}
+
+// Linha vertical de y0 a y1 (inclusive), recortada uma vez.
+static void draw_vline(int x, int y0, int y1) {
+    if (y0 > y1) { int t = y0; y0 = y1; y1 = t; }
+    if (x < 0 || x >= VISIBLE_WIDTH) return;
+    if (y0 < 0) y0 = 0;
+    if (y1 >= VISIBLE_HEIGHT) y1 = VISIBLE_HEIGHT - 1;
+    for (int y = y0; y <= y1; y++) put_pix(x, y);
+}
+
+#define BRESENHAM_LINE(PLOT) do {                          \
+        int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;      \
+        int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;     \
+        int err = dx + dy, e2;                             \
+        while (1) {                                        \
+            PLOT(x0, y0);                                  \
+            if (x0 == x1 && y0 == y1) break;               \
+            e2 = 2 * err;                                  \
+            if (e2 >= dy) { err += dy; x0 += sx; }         \
+            if (e2 <= dx) { err += dx; y0 += sy; }         \
+        }                                                  \
+    } while (0)
+
 void draw_line(int x0, int y0, int x1, int y1) {
-    int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
-    int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
-    int err = dx + dy, e2;
-    while (1) {
-        set_pix(x0, y0);
-        if (x0 == x1 && y0 == y1) break;
-        e2 = 2 * err;
-        if (e2 >= dy) { err += dy; x0 += sx; }
-        if (e2 <= dx) { err += dx; y0 += sy; }
-    }
+    if (y0 == y1) { draw_hline(x0, x1, y0); return; }
+    if (x0 == x1) { draw_vline(x0, y0, y1); return; }
+    // Com as duas pontas visíveis o segmento inteiro é visível.
+    if (is_visible(x0, y0) && is_visible(x1, y1)) BRESENHAM_LINE(put_pix);
+    else BRESENHAM_LINE(set_pix);
 }
 
+#define BRESENHAM_CIRCLE(PLOT) do {                            \
+        int x = -r, y = 0, err = 2 - 2 * r;                    \
+        do {                                                   \
+            PLOT(xc - x, yc + y);                              \
+            PLOT(xc - y, yc - x);                              \
+            PLOT(xc + x, yc - y);                              \
+            PLOT(xc + y, yc + x);                              \
+            int e2 = err;                                      \
+            if (e2 <= y) err += ++y * 2 + 1;                   \
+            if (e2 > x || err > y) err += ++x * 2 + 1;         \
+        } while (x < 0);                                       \
+    } while (0)
+
 void draw_circle(int xc, int yc, int r) {
-    int x = -r, y = 0, err = 2 - 2 * r;
-    do {
-        set_pix(xc - x, yc + y);
-        set_pix(xc - y, yc - x);
-        set_pix(xc + x, yc - y);
-        set_pix(xc + y, yc + x);
-        int e2 = err;
-        if (e2 <= y) err += ++y * 2 + 1;
-        if (e2 > x || err > y) err += ++x * 2 + 1;
-    } while (x < 0);
+    // Caixa envolvente dentro da tela: nenhum ponto precisa de teste.
+    if (r >= 0 && is_visible(xc - r, yc - r) && is_visible(xc + r, yc + r)) BRESENHAM_CIRCLE(put_pix);
+    else BRESENHAM_CIRCLE(set_pix);
 }
 
 void draw_rect(int x0, int y0, int x1, int y1) {
-    draw_line(x0, y0, x1, y0);
-    draw_line(x1, y0, x1, y1);
-    draw_line(x1, y1, x0, y1);
-    draw_line(x0, y1, x0, y0);
+    draw_hline(x0, x1, y0);
+    draw_vline(x1, y0, y1);
+    draw_hline(x1, x0, y1);
+    draw_vline(x0, y1, y0);
 }
 
 void draw_tile(int x0, int y0, int x1, int y1) {
     int ymin = y0 < y1 ? y0 : y1;
     int ymax = y0 > y1 ? y0 : y1;
     int xmin = x0 < x1 ? x0 : x1;
-    int xmax = x0 > y1 ? x0 : x1; // Correção: era x0 > y1, deve ser x0 > x1
+    int xmax = x0 > x1 ? x0 : x1;
+    if (xmin < 0) xmin = 0;
+    if (ymin < 0) ymin = 0;
+    if (xmax >= VISIBLE_WIDTH) xmax = VISIBLE_WIDTH - 1;
+    if (ymax >= VISIBLE_HEIGHT) ymax = VISIBLE_HEIGHT - 1;
     for (int y = ymin; y <= ymax; y++) {
         for (int x = xmin; x <= xmax; x++) {
-            set_pix(x, y);
+            put_pix(x, y);
         }
     }
 }
@@ -14,6 +14,7 @@
 #define PERIPHERAL_BASE 0xFF200000
 #define PERIPHERAL_SIZE 0x00001000 
 #define DEVICES_BUTTONS 0x0050
+#define KEY_EDGECAPTURE 0x005C // Bit ligado a cada aperto até ser apagado; escrever 1 apaga o bit
 
 #define FRAME_BASE      0xC8000000
 #define LWIDTH          512
@@ -68,6 +69,7 @@ int mem_fd = -1;
 volatile uint16_t (*tela)[LWIDTH];
 volatile void *peripheral_map = NULL;
 volatile unsigned int *key_ptr = NULL;
+volatile unsigned int *key_edge_ptr = NULL;
 // Jogo
 GameState state;
 Point snake_body[MAX_SNAKE_LENGTH];
@@ -103,8 +105,8 @@ int init_hardware() {
     }
     tela = (volatile uint16_t (*)[LWIDTH])vga_map;
 
-    // Mapear periféricos (botões)
-    peripheral_map = mmap(NULL, PERIPHERAL_SIZE, PROT_READ, MAP_SHARED, mem_fd, PERIPHERAL_BASE);
+    // Mapear periféricos (botões); escrita para apagar a captura de bordas
+    peripheral_map = mmap(NULL, PERIPHERAL_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, mem_fd, PERIPHERAL_BASE);
     if (peripheral_map == MAP_FAILED) { 
         perror("Erro ao mapear periféricos"); 
         munmap(vga_map, LWIDTH * VISIBLE_HEIGHT * PIXEL_SIZE); 
@@ -112,11 +114,23 @@ int init_hardware() {
         return -1; 
     }
     key_ptr = (volatile unsigned int *)(peripheral_map + DEVICES_BUTTONS);
+    key_edge_ptr = (volatile unsigned int *)(peripheral_map + KEY_EDGECAPTURE);
+    *key_edge_ptr = 0xF; // Descarta apertos anteriores ao jogo
 
     atexit(cleanup_resources);
     return 0;
 }
 
+/**
+ * @brief Lê e apaga os apertos capturados pela PIO desde a última chamada.
+ * O laço dorme até 100 ms por iteração; a captura guarda os toques mais curtos.
+ */
+unsigned int take_key_presses() {
+    unsigned int pressed = *key_edge_ptr & 0xF;
+    if (pressed) *key_edge_ptr = pressed;
+    return pressed;
+}
+
 void draw_grid_rect(int grid_x, int grid_y, uint16_t color) {
     int start_x = grid_x * GRID_SIZE;
     int start_y = grid_y * GRID_SIZE;
@@ -238,11 +252,10 @@ int main() {
     srand(time(NULL));
 
     state = STATE_START_SCREEN;
-    unsigned int prev_key_state = 0x0;
 
     while (1) {
-        unsigned int current_key_state = *key_ptr;
-        if (current_key_state & 0b0001) { break; } // Sair com KEY0
+        unsigned int pressed = take_key_presses();
+        if ((*key_ptr | pressed) & 0b0001) { break; } // Sair com KEY0
 
         switch (state) {
             case STATE_START_SCREEN: {
@@ -256,15 +269,15 @@ int main() {
                 // Simula "Press KEY1/KEY2 to Start"
                 draw_grid_rect(GRID_WIDTH/2, GRID_HEIGHT/2, WHITE);
                 
-                if ((current_key_state & 0b0110) && !(prev_key_state & 0b0110)) { // KEY1 ou KEY2
+                if (pressed & 0b0110) { // KEY1 ou KEY2
                     init_game();
                 }
                 break;
             }
             case STATE_GAME_RUNNING: {
-                // Lógica de controle (virar esquerda/direita com detecção de borda)
-                int key1_pressed = (current_key_state & 0b0010) && !(prev_key_state & 0b0010);
-                int key2_pressed = (current_key_state & 0b0100) && !(prev_key_state & 0b0100);
+                // Lógica de controle (virar esquerda/direita a cada aperto capturado)
+                int key1_pressed = pressed & 0b0010;
+                int key2_pressed = pressed & 0b0100;
 
                 if (key1_pressed) { // Virar à esquerda (não pode inverter direção)
                     if (direction != DOWN && direction != UP) direction = (direction - 1 + 4) % 4; // Evita erro lógico de direção
@@ -295,14 +308,13 @@ int main() {
                 printf("FIM DE JOGO! Pontuacao final: %d. Pressione KEY1 ou KEY2 para jogar novamente.\n", score);
                 
                 // Espera um pressionar de tecla para reiniciar
-                if ((current_key_state & 0b0110) && !(prev_key_state & 0b0110)) {
+                if (pressed & 0b0110) {
                     state = STATE_START_SCREEN;
                 }
                 break;
             }
         }
 
-        prev_key_state = current_key_state;
         // A velocidade aumenta conforme o score (diminuindo o delay)
         int current_delay = INITIAL_SPEED_DELAY - (score * 200);
         if (current_delay < 40000) current_delay = 40000; // Limite máximo de velocidade
@@ -0,0 +1,119 @@
+/**
+ * @file de1soc_sim.c
+ * @brief Controle do arquivo substituto do /dev/mem (backend HW_BACKEND_FILE).
+ *
+ * Permite roteirizar uma partida sem a placa: define KEY e SW, lê os HEX e
+ * salva o framebuffer exibido (segundo o controlador do pixel buffer) como PPM.
+ *
+ * Compilar: gcc -std=c99 tools/de1soc_sim.c de1soc.c -o de1soc_sim
+ * Exemplo:
+ *   ./flappy --sim /dev/shm/de1soc &
+ *   ./de1soc_sim /dev/shm/de1soc sw 0x100   # modo 2 jogadores
+ *   ./de1soc_sim /dev/shm/de1soc key 0x2    # segura KEY1
+ *   ./de1soc_sim /dev/shm/de1soc key 0x0    # solta KEY1
+ *   ./de1soc_sim /dev/shm/de1soc ppm quadro.ppm
+ *   ./de1soc_sim /dev/shm/de1soc key 0x1    # KEY0: encerra o jogo
+ *
+ * Com ./flappy --sim /dev/shm/de1soc --irq /dev/shm/de1soc.irq, o comando key
+ * também escreve no FIFO, como a IRQ da PIO dos KEYs na placa.
+ */
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "../de1soc.h"
+
+static volatile void *peripherals = NULL;
+static volatile uint16_t (*tela)[LWIDTH] = NULL;
+
+static void cleanup(void) {
+    hw_unmap(tela, FRAME_SIZE);
+    hw_unmap(peripherals, PERIPHERAL_SIZE);
+    hw_close();
+}
+
+static volatile unsigned int *reg(unsigned int offset) {
+    return (volatile unsigned int *)(peripherals + offset);
+}
+
+/**
+ * @brief Salva a área visível do framebuffer (RGB565) como PPM binário.
+ */
+static int save_ppm(const char *filename) {
+    FILE *f = fopen(filename, "wb");
+    if (!f) { perror("Erro ao criar o arquivo PPM"); return -1; }
+    fprintf(f, "P6\n%d %d\n255\n", VISIBLE_WIDTH, VISIBLE_HEIGHT);
+    for (int y = 0; y < VISIBLE_HEIGHT; y++) {
+        for (int x = 0; x < VISIBLE_WIDTH; x++) {
+            uint16_t c = tela[y][x];
+            unsigned char rgb[3] = {
+                (unsigned char)(((c >> 11) & 0x1F) << 3),
+                (unsigned char)(((c >> 5) & 0x3F) << 2),
+                (unsigned char)((c & 0x1F) << 3)
+            };
+            fwrite(rgb, 1, 3, f);
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Uso: %s <arquivo> <comando> [valor]\n"
+        "  init            cria/zera os registradores\n"
+        "  sw <valor>      escreve nos switches (SW0-SW9)\n"
+        "  key <valor>     escreve nos botões (KEY0-KEY3), captura as bordas de subida\n"
+        "                  e avisa quem espera a interrupção em <arquivo>.irq\n"
+        "  status          mostra KEY, SW, HEX3-0, HEX5-4 e LEDR\n"
+        "  ppm <saida>     salva a tela visível em PPM\n", prog);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) { usage(argv[0]); return 1; }
+
+    if (hw_open(HW_BACKEND_FILE, argv[1]) != 0) return 1;
+    atexit(cleanup);
+    peripherals = hw_map(PERIPHERAL_BASE, PERIPHERAL_SIZE);
+    tela = (volatile uint16_t (*)[LWIDTH])hw_map(FRAME_BASE, FRAME_SIZE);
+    if (!peripherals || !tela) return 1;
+
+    const char *cmd = argv[2];
+    unsigned int value = argc > 3 ? (unsigned int)strtoul(argv[3], NULL, 0) : 0;
+
+    volatile unsigned int *pixbuf = reg(PIXEL_BUF_CTRL_OFFSET);
+    if (strcmp(cmd, "init") == 0) {
+        memset((void *)peripherals, 0, PERIPHERAL_SIZE);
+        pixbuf[PIXBUF_BUFFER] = FRAME_BASE;
+        pixbuf[PIXBUF_BACKBUFFER] = FRAME_BASE;
+        pixbuf[PIXBUF_RESOLUTION] = (VISIBLE_HEIGHT << 16) | VISIBLE_WIDTH;
+    } else if (strcmp(cmd, "sw") == 0 && argc > 3) {
+        *reg(SWITCHES_OFFSET) = value & 0x3FF;
+    } else if (strcmp(cmd, "key") == 0 && argc > 3) {
+        keys_sim_write(reg(DEVICES_BUTTONS), value);
+        char irq_path[4096];
+        snprintf(irq_path, sizeof(irq_path), "%s.irq", argv[1]);
+        hw_irq_notify(irq_path);
+    } else if (strcmp(cmd, "status") == 0) {
+        printf("KEY=0x%X (capturados 0x%X) SW=0x%03X HEX3_0=0x%08X HEX5_4=0x%04X LEDR=0x%03X\n",
+               reg(DEVICES_BUTTONS)[PIO_DATA], reg(DEVICES_BUTTONS)[PIO_EDGECAPTURE], *reg(SWITCHES_OFFSET),
+               *reg(HEX3_0_OFFSET), *reg(HEX5_4_OFFSET), *reg(LEDR_OFFSET));
+        printf("PIXBUF: front=0x%08X back=0x%08X status=0x%X\n",
+               pixbuf[PIXBUF_BUFFER], pixbuf[PIXBUF_BACKBUFFER], pixbuf[PIXBUF_STATUS]);
+    } else if (strcmp(cmd, "ppm") == 0 && argc > 3) {
+        // Salva o buffer que o controlador está exibindo (pode ser o da SDRAM com --flip).
+        unsigned int front = pixbuf[PIXBUF_BUFFER];
+        if (front != 0 && front != FRAME_BASE) {
+            hw_unmap(tela, FRAME_SIZE);
+            tela = (volatile uint16_t (*)[LWIDTH])hw_map(front, FRAME_SIZE);
+            if (!tela) return 1;
+        }
+        return save_ppm(argv[3]) == 0 ? 0 : 1;
+    } else {
+        usage(argv[0]);
+        return 1;
+    }
+    return 0;
+}
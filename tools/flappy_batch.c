@@ -0,0 +1,289 @@
+/**
+ * @file flappy_batch.c
+ * @brief Simula milhares de partidas em paralelo com o núcleo do jogo
+ * (flappy_core.c) para calibrar as tabelas de dificuldade (SPEED_LEVEL_*,
+ * GAP_*, SPACING_* ...).
+ *
+ * As partidas de todas as configurações formam uma fila única (configuração x
+ * partida) que as threads consomem em blocos de BATCH_CHUNK: configurações em
+ * que as partidas duram mais não deixam as outras threads esperando. Cada
+ * partida tem sua própria semente (semente base + índice na configuração), o
+ * gerador da política aleatória vive na pilha da thread e cada resultado é
+ * gravado na sua posição, então o resultado não depende do número de threads.
+ * A execução é repetida com 1, 2, 4, ... N threads para mostrar a escala em
+ * partidas/s, e depois são mostradas as distribuições de cada configuração.
+ *
+ * Com --all, simula as 256 combinações de SW0-SW7 uma vez, com todas as
+ * threads, e mostra o mapa de dificuldade: tempo de vida e pontuação de cada
+ * combinação, com os parâmetros que ela seleciona (--csv grava o mesmo mapa).
+ *
+ * Compilar: gcc -std=c99 -O2 -pthread tools/flappy_batch.c flappy_core.c -o flappy_batch
+ * Exemplo:  ./flappy_batch --games 4000 --sw 0x000 --sw 0x0AF --policy random
+ *           ./flappy_batch --all --csv dificuldade.csv
+ */
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "../flappy_core.h"
+
+#define DEFAULT_GAMES      2000
+#define DEFAULT_MAX_FRAMES 36000 // 10 minutos de jogo: partidas que chegam aqui são encerradas
+#define MAX_CONFIGS        256
+#define MAX_THREADS        256
+#define RANDOM_JUMP_CHANCE 12    // Política aleatória: pula em média 1 vez a cada 12 quadros
+#define BATCH_CHUNK        16    // Partidas retiradas da fila de cada vez
+#define MAP_GAMES          500   // Padrões de --all: cabem em menos de um minuto
+#define MAP_MAX_FRAMES     3600  // 1 minuto de jogo
+
+typedef enum { POLICY_AUTOPILOT, POLICY_RANDOM } Policy;
+
+typedef struct {
+    unsigned int switches[MAX_CONFIGS];
+    int num_configs;
+    long games;       // Partidas por configuração
+    int max_frames;
+    int max_threads;
+    uint32_t seed;
+    Policy policy;
+    int all;          // Mapa das 256 configurações
+    const char *csv_path;
+} BatchOptions;
+
+// Resultado de uma partida.
+typedef struct {
+    int score;
+    int frames;
+} GameResult;
+
+// Fila das partidas de todas as configurações: a partida t é a t % games da configuração t / games.
+typedef struct {
+    const BatchOptions *opt;
+    GameConfig cfgs[MAX_CONFIGS];
+    long next, total;
+    pthread_mutex_t lock;
+    GameResult *results;
+} BatchQueue;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t xorshift32(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+/**
+ * @brief Joga uma partida de um jogador até o fim ou até max_frames.
+ */
+static GameResult play_game(const GameConfig *cfg, uint32_t seed, Policy policy, int max_frames) {
+    Game game;
+    game_seed(&game, seed);
+    game_reset(&game, cfg);
+    uint32_t policy_rng = seed ^ 0x85EBCA6Bu;
+    if (!policy_rng) policy_rng = 1;
+
+    int f = 0;
+    while (f < max_frames && game.state == GAME_RUNNING) {
+        int jump = policy == POLICY_AUTOPILOT ? autopilot_jump(&game.p1, P1_X_POS, &game, cfg)
+                                              : xorshift32(&policy_rng) % RANDOM_JUMP_CHANCE == 0;
+        game_step(&game, jump ? INPUT_JUMP_P1 : 0, cfg);
+        f++;
+    }
+    return (GameResult){ game.score_p1, f };
+}
+
+static void *batch_worker(void *arg) {
+    BatchQueue *q = arg;
+    const BatchOptions *opt = q->opt;
+    for (;;) {
+        pthread_mutex_lock(&q->lock);
+        long first = q->next;
+        long last = first + BATCH_CHUNK < q->total ? first + BATCH_CHUNK : q->total;
+        q->next = last;
+        pthread_mutex_unlock(&q->lock);
+        if (first >= last) break;
+        for (long t = first; t < last; t++) {
+            uint32_t seed = opt->seed + (uint32_t)(t % opt->games);
+            q->results[t] = play_game(&q->cfgs[t / opt->games], seed, opt->policy, opt->max_frames);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Simula todas as configurações com `threads` threads.
+ * @param results results[c * games + g]: partida g da configuração c.
+ * @return Tempo gasto em ns, ou 0 se não foi possível criar as threads.
+ */
+static uint64_t run_batch(const BatchOptions *opt, int threads, GameResult *results) {
+    pthread_t tids[MAX_THREADS];
+    BatchQueue q;
+    q.opt = opt;
+    q.next = 0;
+    q.total = (long)opt->num_configs * opt->games;
+    q.results = results;
+    // Uma partida por vez, em modo de um jogador e sem pausa.
+    for (int c = 0; c < opt->num_configs; c++) game_config_from_switches(&q.cfgs[c], opt->switches[c] & 0xFF);
+    pthread_mutex_init(&q.lock, NULL);
+
+    uint64_t t0 = now_ns();
+    int started = 0;
+    for (int t = 0; t < threads; t++) {
+        if (pthread_create(&tids[t], NULL, batch_worker, &q) != 0) {
+            perror("Erro ao criar thread");
+            break;
+        }
+        started++;
+    }
+    for (int t = 0; t < started; t++) pthread_join(tids[t], NULL);
+    pthread_mutex_destroy(&q.lock);
+    return started == threads ? now_ns() - t0 : 0;
+}
+
+static int cmp_int(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Mostra, para cada configuração, os parâmetros que os switches
+ * selecionam, a pontuação (média, p50, p90, máximo), o tempo de vida (média e
+ * p50) e a fração de partidas que chegaram a max_frames. Com --csv, grava as
+ * mesmas colunas no arquivo.
+ */
+static int print_distributions(const BatchOptions *opt, const GameResult *results) {
+    int *scores = malloc(opt->games * sizeof(int));
+    int *frames = malloc(opt->games * sizeof(int));
+    if (!scores || !frames) { perror("Erro ao alocar as pontuações"); free(scores); free(frames); return -1; }
+    FILE *csv = NULL;
+    if (opt->csv_path) {
+        csv = fopen(opt->csv_path, "w");
+        if (!csv) { perror("Erro ao abrir o CSV"); free(scores); free(frames); return -1; }
+        fprintf(csv, "sw,speed,gap,pipes,gravity,jump,radius,games,score_mean,score_p50,score_p90,score_max,"
+                     "life_mean_s,life_p50_s,capped_pct\n");
+    }
+    printf("\n%-6s %3s %5s %5s %5s %5s %4s %8s %8s %6s %6s %6s %9s %8s %9s\n", "SW", "vel", "abert", "canos",
+           "grav", "pulo", "raio", "partidas", "média", "p50", "p90", "máx", "vida(s)", "p50(s)", "no limite");
+    for (int c = 0; c < opt->num_configs; c++) {
+        const GameResult *res = &results[c * opt->games];
+        GameConfig cfg;
+        game_config_from_switches(&cfg, opt->switches[c] & 0xFF);
+        double sum = 0, frame_sum = 0;
+        long capped = 0;
+        for (long g = 0; g < opt->games; g++) {
+            scores[g] = res[g].score;
+            frames[g] = res[g].frames;
+            sum += res[g].score;
+            frame_sum += res[g].frames;
+            if (res[g].frames >= opt->max_frames) capped++;
+        }
+        qsort(scores, opt->games, sizeof(int), cmp_int);
+        qsort(frames, opt->games, sizeof(int), cmp_int);
+        double seconds = FRAME_PERIOD_US / 1e6;
+        double gravity = cfg.gravity / (double)FIX16_ONE, jump = cfg.jump_velocity / (double)FIX16_ONE;
+        int p90 = scores[(long)((opt->games - 1) * 0.9)];
+        printf("0x%03X  %3d %5d %5d %5.2f %5.1f %4d %8ld %8.2f %6d %6d %6d %9.1f %8.1f %8.1f%%\n",
+               opt->switches[c], cfg.speed, cfg.gap_height, cfg.num_obstacles, gravity, jump, cfg.bird_radius,
+               opt->games, sum / opt->games, scores[opt->games / 2], p90, scores[opt->games - 1],
+               frame_sum / opt->games * seconds, frames[opt->games / 2] * seconds, 100.0 * capped / opt->games);
+        if (csv) {
+            fprintf(csv, "0x%03X,%d,%d,%d,%.4f,%.4f,%d,%ld,%.3f,%d,%d,%d,%.3f,%.3f,%.2f\n",
+                    opt->switches[c], cfg.speed, cfg.gap_height, cfg.num_obstacles, gravity, jump, cfg.bird_radius,
+                    opt->games, sum / opt->games, scores[opt->games / 2], p90, scores[opt->games - 1],
+                    frame_sum / opt->games * seconds, frames[opt->games / 2] * seconds, 100.0 * capped / opt->games);
+        }
+    }
+    free(scores);
+    free(frames);
+    if (csv && fclose(csv) != 0) { perror("Erro ao gravar o CSV"); return -1; }
+    return 0;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Uso: %s [opções]\n"
+        "  --sw <valor>          configuração SW0-SW7 a simular (repetível; padrão 0x000, 0x010, 0x0AF)\n"
+        "  --games <n>           partidas por configuração (padrão %d)\n"
+        "  --max-frames <n>      limite de quadros por partida (padrão %d)\n"
+        "  --threads <n>         máximo de threads (padrão: núcleos disponíveis)\n"
+        "  --policy <p>          autopilot (padrão) ou random\n"
+        "  --seed <n>            semente base (padrão 1)\n"
+        "  --all                 mapa das 256 configurações de SW0-SW7, sem a medição de escala\n"
+        "                        (padrões: %d partidas, %d quadros)\n"
+        "  --csv <arquivo>       grava a tabela de cada configuração em CSV\n",
+        prog, DEFAULT_GAMES, DEFAULT_MAX_FRAMES, MAP_GAMES, MAP_MAX_FRAMES);
+}
+
+int main(int argc, char **argv) {
+    BatchOptions opt = { { 0 }, 0, 0, 0, 0, 1, POLICY_AUTOPILOT, 0, NULL };
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--sw") == 0 && i + 1 < argc && opt.num_configs < MAX_CONFIGS) {
+            opt.switches[opt.num_configs++] = (unsigned int)strtoul(argv[++i], NULL, 0) & 0xFF;
+        } else if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) opt.games = atol(argv[++i]);
+        else if (strcmp(argv[i], "--max-frames") == 0 && i + 1 < argc) opt.max_frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) opt.max_threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) opt.seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--all") == 0) opt.all = 1;
+        else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) opt.csv_path = argv[++i];
+        else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc) {
+            const char *p = argv[++i];
+            if (strcmp(p, "autopilot") == 0) opt.policy = POLICY_AUTOPILOT;
+            else if (strcmp(p, "random") == 0) opt.policy = POLICY_RANDOM;
+            else { usage(argv[0]); return 1; }
+        } else { usage(argv[0]); return 1; }
+    }
+    if (opt.all) {
+        if (opt.num_configs) { usage(argv[0]); return 1; }
+        for (unsigned int sw = 0; sw < MAX_CONFIGS; sw++) opt.switches[opt.num_configs++] = sw;
+        if (!opt.games) opt.games = MAP_GAMES;
+        if (!opt.max_frames) opt.max_frames = MAP_MAX_FRAMES;
+    } else if (opt.num_configs == 0) {
+        static const unsigned int defaults[] = { 0x000, 0x010, 0x0AF };
+        for (int i = 0; i < 3; i++) opt.switches[opt.num_configs++] = defaults[i];
+    }
+    if (!opt.games) opt.games = DEFAULT_GAMES;
+    if (!opt.max_frames) opt.max_frames = DEFAULT_MAX_FRAMES;
+    if (opt.max_threads <= 0) opt.max_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (opt.max_threads > MAX_THREADS) opt.max_threads = MAX_THREADS;
+    if (opt.games <= 0 || opt.max_frames <= 0 || opt.max_threads <= 0) { usage(argv[0]); return 1; }
+
+    size_t total = (size_t)opt.num_configs * opt.games;
+    GameResult *results = malloc(total * sizeof(GameResult));
+    GameResult *reference = malloc(total * sizeof(GameResult));
+    if (!results || !reference) { perror("Erro ao alocar os resultados"); return 1; }
+
+    printf("%d configuração(ões) x %ld partidas, política %s, até %d quadros por partida\n",
+           opt.num_configs, opt.games, opt.policy == POLICY_AUTOPILOT ? "autopilot" : "random", opt.max_frames);
+    printf("%7s %10s %12s %8s\n", "threads", "tempo(s)", "partidas/s", "escala");
+
+    // Dobra o número de threads até o máximo; o resultado deve ser sempre o mesmo. O mapa roda só com o máximo.
+    double base_rate = 0;
+    int mismatches = 0;
+    for (int threads = opt.all ? opt.max_threads : 1;; threads = threads * 2 > opt.max_threads ? opt.max_threads : threads * 2) {
+        uint64_t ns = run_batch(&opt, threads, base_rate == 0 ? reference : results);
+        if (ns == 0) return 1;
+        double rate = total / (ns / 1e9);
+        if (base_rate == 0) base_rate = rate;
+        else if (memcmp(results, reference, total * sizeof(GameResult)) != 0) mismatches++;
+        printf("%7d %10.3f %12.0f %7.2fx\n", threads, ns / 1e9, rate, rate / base_rate);
+        if (threads == opt.max_threads) break;
+    }
+    if (mismatches) fprintf(stderr, "Resultados diferentes entre execuções com número de threads diferente\n");
+
+    int failed = print_distributions(&opt, reference) != 0;
+    free(results);
+    free(reference);
+    return mismatches || failed ? 1 : 0;
+}
@@ -0,0 +1,738 @@
+/**
+ * @file flappy_bench.c
+ * @brief Benchmark da sequência de renderização do flappy.c.
+ *
+ * Executa render_frame() por N quadros sobre um framebuffer em memória (ou no
+ * arquivo substituto do /dev/mem com --sim) e informa p50/p99/máximo de cada
+ * fase e o total por quadro, em texto e em CSV. Com --mode dirty mede o
+ * renderizador por retângulos sujos; --check compara, quadro a quadro, a tela
+ * produzida por ele com a do render_frame() completo, com um framebuffer e com
+ * dois alternados (o caso do --flip).
+ *
+ * Suítes (--suite):
+ *   render  sequência de renderização do laço principal (padrão)
+ *   blit    memcpy do quadro inteiro x blit_visible() só da área visível
+ *   bird    custo por pássaro: círculo pixel a pixel (versão antiga) x spans x sprite
+ *   physics física do pássaro em double (versão antiga) x Q16.16, com comparação das trajetórias
+ *   population  população de pássaros: um Bird por vez x vetores SIMD, com comparação do estado final
+ *
+ * Compilar: gcc -std=c99 -O2 tools/flappy_bench.c flappy_core.c flappy_population.c flappy_render.c de1soc.c -o flappy_bench -lm
+ * Exemplo:  ./flappy_bench --frames 5000 --csv resultados.csv --label antes
+ */
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <math.h>
+
+#include "../de1soc.h"
+#include "../flappy.h"
+#include "../flappy_render.h"
+#include "../flappy_core.h"
+#include "../flappy_population.h"
+
+#define DEFAULT_FRAMES 10000
+#define WARMUP_FRAMES  100
+
+typedef struct {
+    uint64_t p50, p99, max, mean;
+} Stats;
+
+typedef struct {
+    int frames;
+    int num_obstacles;
+    int bird_radius;
+    int dirty_mode;
+    int check;
+    const char *sim_path;
+} BenchOptions;
+
+// Destino do relatório: texto legível em `out` e, opcionalmente, linhas CSV.
+typedef struct {
+    FILE *out, *csv;
+    const char *label;
+    int frames;
+} Report;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Calcula percentis de uma série de amostras (a série é ordenada no lugar).
+ */
+static Stats compute_stats(uint64_t *samples, int n) {
+    Stats s = {0, 0, 0, 0};
+    if (n <= 0) return s;
+    uint64_t sum = 0;
+    for (int i = 0; i < n; i++) sum += samples[i];
+    qsort(samples, n, sizeof(uint64_t), cmp_u64);
+    s.p50 = samples[n / 2];
+    s.p99 = samples[(int)((n - 1) * 0.99)];
+    s.max = samples[n - 1];
+    s.mean = sum / n;
+    return s;
+}
+
+static int report_open(Report *r, const char *csv_path, const char *label, int frames) {
+    r->csv = NULL;
+    r->label = label;
+    r->frames = frames;
+    if (csv_path) {
+        r->csv = strcmp(csv_path, "-") == 0 ? stdout : fopen(csv_path, "a");
+        if (!r->csv) { perror("Erro ao abrir o CSV"); return -1; }
+        if (r->csv == stdout || ftell(r->csv) == 0) fprintf(r->csv, "label,frames,phase,p50_ns,p99_ns,max_ns,mean_ns\n");
+    }
+    // Com o CSV na saída padrão, o relatório legível vai para stderr.
+    r->out = r->csv == stdout ? stderr : stdout;
+    return 0;
+}
+
+static void report_close(Report *r) {
+    if (r->csv && r->csv != stdout) fclose(r->csv);
+}
+
+static void report_header(Report *r) {
+    fprintf(r->out, "%-14s %10s %10s %10s %10s\n", "fase", "p50(us)", "p99(us)", "max(us)", "média(us)");
+}
+
+static Stats report_row(Report *r, const char *name, uint64_t *samples) {
+    Stats s = compute_stats(samples, r->frames);
+    fprintf(r->out, "%-14s %10.2f %10.2f %10.2f %10.2f\n", name,
+            s.p50 / 1000.0, s.p99 / 1000.0, s.max / 1000.0, s.mean / 1000.0);
+    if (r->csv) {
+        fprintf(r->csv, "%s,%d,%s,%llu,%llu,%llu,%llu\n", r->label, r->frames, name,
+                (unsigned long long)s.p50, (unsigned long long)s.p99,
+                (unsigned long long)s.max, (unsigned long long)s.mean);
+    }
+    return s;
+}
+
+/**
+ * @brief Avança uma cena roteirizada: canos rolando e pássaros pulando,
+ * sem colisões, para que todo quadro tenha o mesmo tipo de conteúdo do jogo.
+ */
+static void advance_scene(Bird *p1, Bird *p2, Obstacle obstacles[], int num_obstacles,
+                          int speed, int spacing, int gap_height, unsigned int *seed) {
+    Bird *birds[2] = { p1, p2 };
+    for (int b = 0; b < 2; b++) {
+        birds[b]->velocity_y += FIX16(GRAVITY_EASY);
+        birds[b]->y += birds[b]->velocity_y;
+        if (birds[b]->y > FIX16(VISIBLE_HEIGHT * 0.7)) birds[b]->velocity_y = FIX16(JUMP_EASY);
+    }
+    for (int i = 0; i < num_obstacles; i++) {
+        obstacles[i].x -= speed;
+        if (obstacles[i].x + OBSTACLE_WIDTH < 0) {
+            int max_x = 0;
+            for (int j = 0; j < num_obstacles; j++) {
+                if (obstacles[j].x > max_x) max_x = obstacles[j].x;
+            }
+            *seed = *seed * 1103515245u + 12345u;
+            obstacles[i].x = max_x + spacing;
+            obstacles[i].gap_y = (int)((*seed >> 16) % (VISIBLE_HEIGHT - gap_height - 60)) + 30;
+        }
+    }
+}
+
+/**
+ * @brief Confere o histórico de dois alvos usado com --flip: cada quadro é
+ * desenhado por render_scene_dirty() e enviado, alternadamente, a um de dois
+ * buffers em RAM com present_dirty(), e o buffer recebido é comparado com o
+ * render_frame() completo da mesma cena. Um retângulo esquecido no histórico
+ * damage[0..2] deixa restos do quadro de dois quadros atrás no buffer.
+ * @return Número de quadros divergentes.
+ */
+static int check_two_targets(const BenchOptions *opt) {
+    uint16_t *targets[2] = { alloc_frame(), alloc_frame() };
+    uint16_t *reference = alloc_frame();
+    uint16_t *back_buffer = alloc_frame();
+    DirtyRenderer dirty;
+    if (!targets[0] || !targets[1] || !reference || !back_buffer || dirty_renderer_init(&dirty, 2) != 0) {
+        perror("Erro ao alocar os buffers");
+        exit(1);
+    }
+    int mismatches = 0;
+
+    Bird p1 = { FIX16_FROM_INT(VISIBLE_HEIGHT / 2), 0, 1 };
+    Bird p2 = { FIX16_FROM_INT(VISIBLE_HEIGHT / 3), 0, 1 };
+    Obstacle obstacles[NUM_PIPES_HARD];
+    unsigned int seed = 1;
+    for (int i = 0; i < opt->num_obstacles; i++) {
+        obstacles[i].x = VISIBLE_WIDTH / 2 + i * SPACING_HARD;
+        obstacles[i].gap_y = 60 + 30 * i;
+        obstacles[i].scored = 0;
+    }
+    RenderScene scene = { &p1, &p2, obstacles, opt->num_obstacles, GAP_EASY, opt->bird_radius, 0, 0, NULL, 0 };
+
+    static const int check_gaps[4] = { GAP_EASY, GAP_HARDEST, GAP_EASIEST, GAP_HARD };
+    volatile uint16_t (*screen)[LWIDTH] = tela;
+    for (int f = 0; f < opt->frames + WARMUP_FRAMES; f++) {
+        scene.gap_height = check_gaps[(f / 300) % 4];
+        scene.num_obstacles = opt->num_obstacles > 2 && (f / 700) % 2 ? 2 : opt->num_obstacles;
+        advance_scene(&p1, &p2, obstacles, scene.num_obstacles, SPEED_LEVEL_1, SPACING_HARD, scene.gap_height, &seed);
+        scene.score = f / 60;
+        scene.is_paused = (f / 500) % 4 == 3;
+
+        int t = f & 1;
+        render_scene_dirty(&dirty, &scene, NULL);
+        present_dirty(&dirty, t, (volatile uint16_t (*)[LWIDTH])targets[t]);
+
+        tela = (volatile uint16_t (*)[LWIDTH])reference;
+        render_frame(&scene, back_buffer, NULL);
+        tela = screen;
+        for (int y = 0; y < VISIBLE_HEIGHT; y++) {
+            if (memcmp(&targets[t][y * LWIDTH], &reference[y * LWIDTH], VISIBLE_WIDTH * PIXEL_SIZE) != 0) {
+                if (mismatches++ < 10) fprintf(stderr, "Quadro %d (alvo %d) difere na linha %d\n", f, t, y);
+                break;
+            }
+        }
+    }
+
+    free(targets[0]);
+    free(targets[1]);
+    free(reference);
+    free(back_buffer);
+    dirty_renderer_free(&dirty);
+    return mismatches;
+}
+
+/**
+ * @brief Suíte "render": mede cada fase de render_frame()/render_frame_dirty().
+ * @return Número de quadros divergentes no modo --check (um e dois alvos).
+ */
+static int run_render_suite(const BenchOptions *opt, Report *r) {
+    int frames = opt->frames;
+    int dirty_mode = opt->dirty_mode || opt->check;
+    uint16_t *back_buffer = alloc_frame();
+    uint16_t *reference = opt->check ? alloc_frame() : NULL;
+    uint64_t *samples[RENDER_PHASE_COUNT + 1];
+    for (int p = 0; p <= RENDER_PHASE_COUNT; p++) {
+        samples[p] = malloc(frames * sizeof(uint64_t));
+        if (!samples[p]) { perror("Erro ao alocar as amostras"); exit(1); }
+    }
+    DirtyRenderer dirty;
+    if (!back_buffer || (opt->check && !reference) || dirty_renderer_init(&dirty, 1) != 0) {
+        perror("Erro ao alocar os buffers");
+        exit(1);
+    }
+    int mismatches = 0;
+
+    Bird p1 = { FIX16_FROM_INT(VISIBLE_HEIGHT / 2), 0, 1 };
+    Bird p2 = { FIX16_FROM_INT(VISIBLE_HEIGHT / 3), 0, 1 };
+    Obstacle obstacles[NUM_PIPES_HARD];
+    unsigned int seed = 1;
+    for (int i = 0; i < opt->num_obstacles; i++) {
+        obstacles[i].x = VISIBLE_WIDTH / 2 + i * SPACING_HARD;
+        obstacles[i].gap_y = 60 + 30 * i;
+        obstacles[i].scored = 0;
+    }
+
+    RenderScene scene = { &p1, &p2, obstacles, opt->num_obstacles, GAP_EASY, opt->bird_radius, 0, 0, NULL, 0 };
+    uint64_t phase_ns[RENDER_PHASE_COUNT];
+
+    static const int check_gaps[4] = { GAP_EASY, GAP_HARDEST, GAP_EASIEST, GAP_HARD };
+    for (int f = -WARMUP_FRAMES; f < frames; f++) {
+        if (opt->check) {
+            // Troca a abertura e o número de canos, como os switches fazem no jogo.
+            scene.gap_height = check_gaps[((f + WARMUP_FRAMES) / 300) % 4];
+            scene.num_obstacles = opt->num_obstacles > 2 && ((f + WARMUP_FRAMES) / 700) % 2 ? 2 : opt->num_obstacles;
+        }
+        advance_scene(&p1, &p2, obstacles, scene.num_obstacles, SPEED_LEVEL_1, SPACING_HARD, scene.gap_height, &seed);
+        scene.score = (f + WARMUP_FRAMES) / 60;
+        scene.is_paused = (f / 500) % 4 == 3;
+        if (f == 0) dirty.pixels_presented = 0;
+        if (dirty_mode) render_frame_dirty(&dirty, &scene, phase_ns);
+        else render_frame(&scene, back_buffer, phase_ns);
+        if (opt->check) {
+            volatile uint16_t (*screen)[LWIDTH] = tela;
+            tela = (volatile uint16_t (*)[LWIDTH])reference;
+            render_frame(&scene, back_buffer, NULL);
+            tela = screen;
+            for (int y = 0; y < VISIBLE_HEIGHT; y++) {
+                if (memcmp((const void*)tela[y], &reference[y * LWIDTH], VISIBLE_WIDTH * PIXEL_SIZE) != 0) {
+                    if (mismatches++ < 10) fprintf(stderr, "Quadro %d difere na linha %d\n", f, y);
+                    break;
+                }
+            }
+        }
+        if (f < 0) continue;
+        uint64_t total = 0;
+        for (int p = 0; p < RENDER_PHASE_COUNT; p++) {
+            samples[p][f] = phase_ns[p];
+            total += phase_ns[p];
+        }
+        samples[RENDER_PHASE_COUNT][f] = total;
+    }
+
+    fprintf(r->out, "%d quadros, %d canos, raio %d, modo %s, framebuffer %s\n", frames, opt->num_obstacles,
+            opt->bird_radius, dirty_mode ? "dirty" : "full", opt->sim_path ? opt->sim_path : "em memória");
+    report_header(r);
+    for (int p = 0; p < RENDER_PHASE_COUNT; p++) {
+        report_row(r, render_phase_names[p], samples[p]);
+    }
+    Stats total = report_row(r, "total", samples[RENDER_PHASE_COUNT]);
+    fprintf(r->out, "total: %llu ns/quadro (média), %.1f%% do orçamento de %d us\n",
+            (unsigned long long)total.mean, 100.0 * total.mean / (FRAME_PERIOD_US * 1000.0), FRAME_PERIOD_US);
+
+    uint64_t pixels = dirty_mode ? dirty.pixels_presented / frames : (uint64_t)VISIBLE_WIDTH * VISIBLE_HEIGHT;
+    fprintf(r->out, "framebuffer: %llu pixels (%llu bytes) escritos por quadro\n",
+            (unsigned long long)pixels, (unsigned long long)pixels * PIXEL_SIZE);
+    if (opt->check) {
+        fprintf(r->out, "verificação: %d quadro(s) divergente(s)\n", mismatches);
+        int flip_mismatches = check_two_targets(opt);
+        fprintf(r->out, "verificação com dois alvos (--flip): %d quadro(s) divergente(s)\n", flip_mismatches);
+        mismatches += flip_mismatches;
+    }
+
+    for (int p = 0; p <= RENDER_PHASE_COUNT; p++) free(samples[p]);
+    free(back_buffer);
+    free(reference);
+    dirty_renderer_free(&dirty);
+    return mismatches;
+}
+
+/**
+ * @brief Suíte "blit": memcpy de FRAME_SIZE bytes (caminho antigo) x blit_visible().
+ */
+static int run_blit_suite(const BenchOptions *opt, Report *r) {
+    int frames = opt->frames;
+    uint16_t *src = alloc_frame();
+    uint64_t *memcpy_ns = malloc(frames * sizeof(uint64_t));
+    uint64_t *blit_ns = malloc(frames * sizeof(uint64_t));
+    if (!src || !memcpy_ns || !blit_ns) { perror("Erro ao alocar os buffers"); exit(1); }
+    for (int i = 0; i < LWIDTH * VISIBLE_HEIGHT; i++) src[i] = (uint16_t)(i * 2654435761u >> 16);
+
+    for (int f = -WARMUP_FRAMES; f < frames; f++) {
+        uint64_t t0 = now_ns();
+        memcpy((void*)tela, src, FRAME_SIZE);
+        uint64_t t1 = now_ns();
+        blit_visible(tela, src);
+        uint64_t t2 = now_ns();
+        if (f < 0) continue;
+        memcpy_ns[f] = t1 - t0;
+        blit_ns[f] = t2 - t1;
+    }
+
+    int mismatches = 0;
+    for (int y = 0; y < VISIBLE_HEIGHT; y++) {
+        if (memcmp((const void*)tela[y], &src[y * LWIDTH], VISIBLE_WIDTH * PIXEL_SIZE) != 0) mismatches++;
+    }
+
+    fprintf(r->out, "%d cópias, framebuffer %s\n", frames, opt->sim_path ? opt->sim_path : "em memória");
+    report_header(r);
+    Stats full = report_row(r, "memcpy", memcpy_ns);
+    Stats visible = report_row(r, "blit_visible", blit_ns);
+    fprintf(r->out, "bytes por quadro: memcpy %d, blit_visible %d; p50 %.2fx mais rápido\n",
+            FRAME_SIZE, VISIBLE_WIDTH * VISIBLE_HEIGHT * PIXEL_SIZE,
+            visible.p50 ? (double)full.p50 / visible.p50 : 0.0);
+    if (mismatches) fprintf(stderr, "blit_visible: %d linha(s) divergente(s)\n", mismatches);
+
+    free(src);
+    free(memcpy_ns);
+    free(blit_ns);
+    return mismatches;
+}
+
+/*
+ * Versão original do pássaro, com o círculo testando x*x + y*y <= r*r em cada
+ * um dos (2r+1)^2 pixels candidatos. Mantida aqui só como referência de custo
+ * e de resultado para a suíte "bird".
+ */
+static void draw_circle_per_pixel(int xc, int yc, int r, uint16_t color) {
+    for (int y = -r; y <= r; y++) {
+        for (int x = -r; x <= r; x++) {
+            if (x * x + y * y <= r * r) {
+                set_pix(xc + x, yc + y, color);
+            }
+        }
+    }
+}
+
+static void draw_flappy_bird_per_pixel(int x, int y, uint16_t body_color, int bird_radius) {
+    draw_circle_per_pixel(x, y, bird_radius, body_color);
+    draw_circle_per_pixel(x + bird_radius / 2, y - bird_radius / 3, bird_radius / 4, WHITE);
+    set_pix(x + bird_radius / 2, y - bird_radius / 3, BLACK);
+    draw_filled_rect(x + bird_radius, y - 2, x + bird_radius + 5, y + 2, BEAK_COLOR);
+    draw_filled_rect(x - bird_radius / 2, y, x, y + 5, WHITE);
+}
+
+/**
+ * @brief Suíte "bird": tempo de desenhar um pássaro com o círculo pixel a pixel
+ * original, com as primitivas atuais (spans) e com o sprite em cache, para os
+ * dois raios do jogo. As posições incluem pássaros cortados pelas bordas, e as
+ * três versões precisam produzir os mesmos pixels.
+ */
+static int run_bird_suite(const BenchOptions *opt, Report *r) {
+    typedef void (*BirdFn)(int, int, uint16_t, int);
+    static const BirdFn fns[3] = { draw_flappy_bird_per_pixel, draw_flappy_bird_shapes, draw_flappy_bird };
+    static const char *const names[3] = { "pixel", "span", "sprite" };
+
+    int frames = opt->frames;
+    uint16_t *canvas[3];
+    uint64_t *samples[3];
+    for (int v = 0; v < 3; v++) {
+        canvas[v] = alloc_frame();
+        samples[v] = malloc(frames * sizeof(uint64_t));
+        if (!canvas[v] || !samples[v]) { perror("Erro ao alocar os buffers"); exit(1); }
+        memset(canvas[v], 0, FRAME_SIZE);
+    }
+    volatile uint16_t (*screen)[LWIDTH] = tela;
+    int mismatches = 0;
+    const int radii[2] = { RADIUS_EASY, RADIUS_HARD };
+
+    fprintf(r->out, "%d pássaros por raio (tempo por pássaro)\n", frames);
+    report_header(r);
+    for (int k = 0; k < 2; k++) {
+        int radius = radii[k];
+        prepare_bird_tables(radius);
+        for (int f = -WARMUP_FRAMES; f < frames; f++) {
+            int i = f < 0 ? -f : f;
+            int y = (i * 7) % (VISIBLE_HEIGHT + 2 * radius) - radius;
+            int x = i % 5 == 0 ? VISIBLE_WIDTH - 3 : (i % 7 == 0 ? 2 : P1_X_POS);
+            uint16_t color = i % 3 == 0 ? P2_COLOR : P1_COLOR;
+            for (int v = 0; v < 3; v++) {
+                tela = (volatile uint16_t (*)[LWIDTH])canvas[v];
+                uint64_t t0 = now_ns();
+                fns[v](x, y, color, radius);
+                uint64_t t1 = now_ns();
+                if (f >= 0) samples[v][f] = t1 - t0;
+            }
+        }
+        for (int v = 1; v < 3; v++) {
+            if (memcmp(canvas[0], canvas[v], FRAME_SIZE) != 0) mismatches++;
+        }
+
+        Stats stats[3];
+        for (int v = 0; v < 3; v++) {
+            char name[32];
+            snprintf(name, sizeof(name), "bird_r%d_%s", radius, names[v]);
+            stats[v] = report_row(r, name, samples[v]);
+        }
+        fprintf(r->out, "raio %d: p50 spans %.2fx, sprite %.2fx mais rápido que pixel a pixel\n", radius,
+                stats[1].p50 ? (double)stats[0].p50 / stats[1].p50 : 0.0,
+                stats[2].p50 ? (double)stats[0].p50 / stats[2].p50 : 0.0);
+    }
+    tela = screen;
+    if (mismatches) fprintf(stderr, "bird: %d variante(s) com pixels divergentes\n", mismatches);
+
+    for (int v = 0; v < 3; v++) {
+        free(canvas[v]);
+        free(samples[v]);
+    }
+    return mismatches;
+}
+
+/*
+ * Física original do pássaro, em double. Mantida aqui só como referência de
+ * custo e de trajetória para a suíte "physics".
+ */
+typedef struct { double y, velocity_y; int alive; } DoubleBird;
+
+static void double_bird_step(DoubleBird *bird, int jump, double gravity, double jump_velocity) {
+    if (!bird->alive) return;
+    if (jump) bird->velocity_y = jump_velocity;
+    bird->velocity_y += gravity;
+    bird->y += bird->velocity_y;
+}
+
+#define PHYSICS_BIRDS       1024 // Pássaros atualizados por amostra na medição de custo
+#define TRAJECTORIES        1000 // Trajetórias comparadas por combinação de gravidade e pulo
+#define TRAJECTORY_FRAMES   600  // 10 s de jogo por trajetória
+#define TRAJECTORY_TOLERANCE 0.1 // Diferença de posição aceita (px)
+
+/**
+ * @brief Suíte "physics": custo de um passo de física por pássaro em double e
+ * em Q16.16, e comparação das trajetórias das duas versões para as quatro
+ * combinações de gravidade (SW5) e pulo (SW6). Cada trajetória parte do centro
+ * da tela e pula em quadros sorteados (e sempre que o pássaro passa de 70% da
+ * altura). GRAVITY_HARD (0,35) não é exato nem em double nem em Q16.16, então as
+ * posições se afastam um pouco; a verificação falha se a diferença passar de
+ * TRAJECTORY_TOLERANCE ou se as versões discordarem sobre a colisão com as
+ * bordas da tela quando o pássaro não está a menos dessa distância da borda.
+ * @return Número de combinações que falharam na verificação.
+ */
+static int run_physics_suite(const BenchOptions *opt, Report *r) {
+    int frames = opt->frames;
+    uint64_t *double_ns = malloc(frames * sizeof(uint64_t));
+    uint64_t *fixed_ns = malloc(frames * sizeof(uint64_t));
+    DoubleBird *dbirds = malloc(PHYSICS_BIRDS * sizeof(DoubleBird));
+    Bird *fbirds = malloc(PHYSICS_BIRDS * sizeof(Bird));
+    if (!double_ns || !fixed_ns || !dbirds || !fbirds) { perror("Erro ao alocar os buffers"); exit(1); }
+
+    GameConfig cfg;
+    game_config_from_switches(&cfg, 0);
+    for (int i = 0; i < PHYSICS_BIRDS; i++) {
+        dbirds[i] = (DoubleBird){ 20.0 + i % 200, 0, 1 };
+        fbirds[i] = (Bird){ FIX16_FROM_INT(20 + i % 200), 0, 1 };
+    }
+    volatile int sink = 0; // Impede que o compilador descarte os laços
+    for (int f = -WARMUP_FRAMES; f < frames; f++) {
+        int jump_phase = (f & 31) == 0;
+        uint64_t t0 = now_ns();
+        for (int i = 0; i < PHYSICS_BIRDS; i++) {
+            double_bird_step(&dbirds[i], jump_phase, GRAVITY_EASY, JUMP_EASY);
+            sink += (int)dbirds[i].y;
+        }
+        uint64_t t1 = now_ns();
+        for (int i = 0; i < PHYSICS_BIRDS; i++) {
+            bird_step(&fbirds[i], jump_phase, &cfg);
+            sink += FIX16_TO_INT(fbirds[i].y);
+        }
+        uint64_t t2 = now_ns();
+        if (f < 0) continue;
+        double_ns[f] = t1 - t0;
+        fixed_ns[f] = t2 - t1;
+    }
+    (void)sink;
+
+    fprintf(r->out, "%d amostras de %d pássaros\n", frames, PHYSICS_BIRDS);
+    report_header(r);
+    Stats sd = report_row(r, "physics_double", double_ns);
+    Stats sf = report_row(r, "physics_fix16", fixed_ns);
+    fprintf(r->out, "por pássaro: double %.2f ns, Q16.16 %.2f ns (p50)\n",
+            (double)sd.p50 / PHYSICS_BIRDS, (double)sf.p50 / PHYSICS_BIRDS);
+
+    int failures = 0;
+    for (unsigned int sw = 0; sw < 4; sw++) {
+        game_config_from_switches(&cfg, sw << 5);
+        double gravity = (sw & 1) ? GRAVITY_HARD : GRAVITY_EASY;
+        double jump_velocity = (sw & 2) ? JUMP_HARD : JUMP_EASY;
+        unsigned int seed = 12345u + sw;
+        double max_diff = 0;
+        long row_diffs = 0, collision_diffs = 0, edge_cases = 0, compared = 0;
+        for (int t = 0; t < TRAJECTORIES; t++) {
+            DoubleBird db = { VISIBLE_HEIGHT / 2.0, 0, 1 };
+            Bird fb = { FIX16_FROM_INT(VISIBLE_HEIGHT / 2), 0, 1 };
+            for (int f = 0; f < TRAJECTORY_FRAMES; f++) {
+                seed = seed * 1103515245u + 12345u;
+                int jump = ((seed >> 16) % 24) == 0 || db.y > VISIBLE_HEIGHT * 0.7;
+                double_bird_step(&db, jump, gravity, jump_velocity);
+                bird_step(&fb, jump, &cfg);
+                double diff = fb.y / (double)FIX16_ONE - db.y;
+                if (diff < 0) diff = -diff;
+                if (diff > max_diff) max_diff = diff;
+                int double_hit = db.y - cfg.bird_radius < 0 || db.y + cfg.bird_radius > VISIBLE_HEIGHT;
+                Obstacle none = { VISIBLE_WIDTH * 2, 0, 0 };
+                int fixed_hit = check_collision(&fb, P1_X_POS, &none, cfg.bird_radius, 0);
+                if (double_hit != fixed_hit) {
+                    double edge = fmin(fabs(db.y - cfg.bird_radius), fabs(db.y + cfg.bird_radius - VISIBLE_HEIGHT));
+                    if (edge < TRAJECTORY_TOLERANCE) edge_cases++;
+                    else collision_diffs++;
+                }
+                if ((int)floor(db.y) != FIX16_TO_INT(fb.y)) row_diffs++;
+                compared++;
+                if (double_hit || fixed_hit) break;
+            }
+        }
+        int ok = max_diff < TRAJECTORY_TOLERANCE && collision_diffs == 0;
+        if (!ok) failures++;
+        fprintf(r->out, "SW5=%u SW6=%u: %ld quadros, diferença máxima %.4f px, linha diferente em %ld (%.2f%%), "
+                "colisão diferente em %ld (+%ld na borda): %s\n", sw & 1, (sw >> 1) & 1, compared, max_diff,
+                row_diffs, 100.0 * row_diffs / compared, collision_diffs, edge_cases, ok ? "ok" : "FALHOU");
+    }
+
+    free(double_ns);
+    free(fixed_ns);
+    free(dbirds);
+    free(fbirds);
+    return failures;
+}
+
+static const int population_sizes[] = { 1024, 8192, 32768, 131072 };
+static const unsigned int population_switches[] = { 0x000, 0x0AF, 0x0FF };
+
+/*
+ * Referência da suíte "population": os mesmos pássaros como um vetor de Bird,
+ * cada um passando por bird_step() e check_collision() com cada cano, como o
+ * laço do jogo faz com P1 e P2.
+ */
+typedef struct {
+    Bird *birds;
+    int *score;
+    int passed;
+} ScalarPopulation;
+
+static void scalar_population_reset(ScalarPopulation *sp, const BirdPopulation *pop) {
+    for (int i = 0; i < pop->count; i++) {
+        sp->birds[i] = (Bird){ pop->y[i], pop->velocity_y[i], 1 };
+        sp->score[i] = 0;
+    }
+    sp->passed = 0;
+}
+
+static int scalar_population_step(ScalarPopulation *sp, const fix16 *margin, int count, Game *course, const GameConfig *cfg) {
+    fix16 floor_y = FIX16_FROM_INT(next_gap_floor(course, P1_X_POS, cfg));
+    sp->passed += course_step(course, cfg);
+    int alive = 0;
+    for (int i = 0; i < count; i++) {
+        Bird *b = &sp->birds[i];
+        if (!b->alive) continue;
+        fix16 next_y = b->y + b->velocity_y + cfg->gravity;
+        bird_step(b, next_y + FIX16_FROM_INT(cfg->bird_radius) > floor_y - margin[i], cfg);
+        for (int o = 0; o < cfg->num_obstacles && b->alive; o++) {
+            if (check_collision(b, P1_X_POS, &course->obstacles[o], cfg->bird_radius, cfg->gap_height)) {
+                b->alive = 0;
+                sp->score[i] = sp->passed;
+            }
+        }
+        alive += b->alive;
+    }
+    return alive;
+}
+
+/**
+ * @brief Suíte "population": custo por quadro de N pássaros no piloto automático
+ * (cada um com a sua folga) como vetor de Bird e como BirdPopulation, e quantos
+ * pássaros cabem em FRAME_PERIOD_US. As duas versões jogam no mesmo percurso
+ * (mesma semente) e a partida recomeça quando a população inteira morre; ao fim
+ * de cada configuração, y, velocidade, vivo e pontuação de todos os pássaros
+ * precisam ser iguais.
+ * @return Número de (configuração, tamanho) em que as versões divergiram.
+ */
+static int run_population_suite(const BenchOptions *opt, Report *r) {
+    int frames = opt->frames;
+    int num_sizes = sizeof(population_sizes) / sizeof(population_sizes[0]);
+    int max_birds = population_sizes[num_sizes - 1];
+    uint64_t *scalar_ns = malloc(frames * sizeof(uint64_t));
+    uint64_t *simd_ns = malloc(frames * sizeof(uint64_t));
+    ScalarPopulation sp = { malloc(max_birds * sizeof(Bird)), malloc(max_birds * sizeof(int)), 0 };
+    if (!scalar_ns || !simd_ns || !sp.birds || !sp.score) { perror("Erro ao alocar os buffers"); exit(1); }
+
+    int failures = 0;
+    for (size_t c = 0; c < sizeof(population_switches) / sizeof(population_switches[0]); c++) {
+        GameConfig cfg;
+        game_config_from_switches(&cfg, population_switches[c]);
+        fprintf(r->out, "SW 0x%03X, %d quadros\n", population_switches[c], frames);
+        report_header(r);
+        for (int s = 0; s < num_sizes; s++) {
+            int n = population_sizes[s];
+            BirdPopulation pop;
+            if (population_init(&pop, n) != 0) { perror("Erro ao alocar a população"); exit(1); }
+            Game simd_course, scalar_course;
+            game_seed(&simd_course, 2024);
+            game_seed(&scalar_course, 2024);
+            game_reset(&simd_course, &cfg);
+            game_reset(&scalar_course, &cfg);
+            population_reset(&pop, &cfg, 7);
+            scalar_population_reset(&sp, &pop);
+            long restarts = 0, alive_sum = 0;
+
+            for (int f = 0; f < frames; f++) {
+                uint64_t t0 = now_ns();
+                scalar_population_step(&sp, pop.margin, n, &scalar_course, &cfg);
+                uint64_t t1 = now_ns();
+                int alive = population_step(&pop, &simd_course, &cfg);
+                uint64_t t2 = now_ns();
+                scalar_ns[f] = t1 - t0;
+                simd_ns[f] = t2 - t1;
+                alive_sum += alive;
+                if (simd_course.state == GAME_OVER && f + 1 < frames) {
+                    // Mesmo recomeço nas duas versões (o percurso continua a sequência da semente).
+                    game_reset(&simd_course, &cfg);
+                    game_reset(&scalar_course, &cfg);
+                    population_reset(&pop, &cfg, 7 + (uint32_t)++restarts);
+                    scalar_population_reset(&sp, &pop);
+                }
+            }
+
+            long diffs = 0;
+            for (int i = 0; i < n; i++) {
+                const Bird *b = &sp.birds[i];
+                if (b->y != pop.y[i] || b->velocity_y != pop.velocity_y[i] || b->alive != (pop.alive[i] != 0) ||
+                    (b->alive ? sp.passed : sp.score[i]) != population_score(&pop, i)) diffs++;
+            }
+            if (diffs) failures++;
+
+            char name[32];
+            snprintf(name, sizeof(name), "bird_%d", n);
+            Stats ss = report_row(r, name, scalar_ns);
+            snprintf(name, sizeof(name), "simd_%d", n);
+            Stats sv = report_row(r, name, simd_ns);
+            double per_bird = (double)sv.p50 / n;
+            fprintf(r->out, "  %d pássaros: %.2f ns/pássaro (Bird %.2f ns), %.1fx; vivos em média %.0f, %ld recomeços; "
+                    "cabem %.1f milhões de pássaros em %d us; estado final %s (%ld diferentes)\n",
+                    n, per_bird, (double)ss.p50 / n, sv.p50 ? (double)ss.p50 / sv.p50 : 0.0, (double)alive_sum / frames,
+                    restarts, per_bird > 0 ? FRAME_PERIOD_US * 1000.0 / per_bird / 1e6 : 0.0, FRAME_PERIOD_US,
+                    diffs ? "DIFERENTE" : "igual", diffs);
+            population_free(&pop);
+        }
+    }
+
+    free(scalar_ns);
+    free(simd_ns);
+    free(sp.birds);
+    free(sp.score);
+    return failures;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Uso: %s [opções]\n"
+        "  --suite <s>       render (padrão), blit, bird, physics ou population\n"
+        "  --frames <n>      quadros medidos (padrão %d)\n"
+        "  --pipes <2|3>     número de canos (padrão %d)\n"
+        "  --radius <r>      raio dos pássaros (padrão %d)\n"
+        "  --csv <arquivo>   grava o resultado em CSV ('-' para a saída padrão)\n"
+        "  --label <nome>    rótulo da execução na coluna 'label' do CSV\n"
+        "  --sim <arquivo>   usa o framebuffer do arquivo substituto do /dev/mem\n"
+        "  --mode <m>        full (render_frame) ou dirty (render_frame_dirty)\n"
+        "  --check           confere o modo dirty (um alvo e dois alternados) contra o full a cada quadro\n",
+        prog, DEFAULT_FRAMES, NUM_PIPES_HARD, RADIUS_EASY);
+}
+
+int main(int argc, char **argv) {
+    BenchOptions opt = { DEFAULT_FRAMES, NUM_PIPES_HARD, RADIUS_EASY, 0, 0, NULL };
+    const char *suite = "render";
+    const char *csv_path = NULL;
+    const char *label = "flappy";
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--suite") == 0 && i + 1 < argc) suite = argv[++i];
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) opt.frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--pipes") == 0 && i + 1 < argc) opt.num_obstacles = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--radius") == 0 && i + 1 < argc) opt.bird_radius = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) csv_path = argv[++i];
+        else if (strcmp(argv[i], "--label") == 0 && i + 1 < argc) label = argv[++i];
+        else if (strcmp(argv[i], "--sim") == 0 && i + 1 < argc) opt.sim_path = argv[++i];
+        else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) opt.dirty_mode = strcmp(argv[++i], "dirty") == 0;
+        else if (strcmp(argv[i], "--check") == 0) opt.check = 1;
+        else { usage(argv[0]); return 1; }
+    }
+    if (opt.frames <= 0 || opt.num_obstacles < 1 || opt.num_obstacles > NUM_PIPES_HARD) { usage(argv[0]); return 1; }
+
+    uint16_t *front = NULL;
+    if (opt.sim_path) {
+        if (hw_open(HW_BACKEND_FILE, opt.sim_path) != 0) return 1;
+        tela = (volatile uint16_t (*)[LWIDTH])hw_map(FRAME_BASE, FRAME_SIZE);
+        if (!tela) return 1;
+    } else {
+        front = alloc_frame();
+        if (!front) { perror("Erro ao alocar o framebuffer"); return 1; }
+        tela = (volatile uint16_t (*)[LWIDTH])front;
+    }
+
+    Report report;
+    if (report_open(&report, csv_path, label, opt.frames) != 0) return 1;
+
+    int failures;
+    if (strcmp(suite, "render") == 0) failures = run_render_suite(&opt, &report);
+    else if (strcmp(suite, "blit") == 0) failures = run_blit_suite(&opt, &report);
+    else if (strcmp(suite, "bird") == 0) failures = run_bird_suite(&opt, &report);
+    else if (strcmp(suite, "physics") == 0) failures = run_physics_suite(&opt, &report);
+    else if (strcmp(suite, "population") == 0) failures = run_population_suite(&opt, &report);
+    else { usage(argv[0]); return 1; }
+
+    report_close(&report);
+    free(front);
+    if (opt.sim_path) { hw_unmap(tela, FRAME_SIZE); hw_close(); }
+    return failures ? 1 : 0;
+}
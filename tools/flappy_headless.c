@@ -0,0 +1,83 @@
+/**
+ * @file flappy_headless.c
+ * @brief Executa o núcleo do jogo (flappy_core.c) sem placa, sem desenho e sem
+ * esperar entre quadros, para medir quantos passos de física por segundo ele faz.
+ *
+ * Os pulos vêm do piloto automático de referência (autopilot_jump), que pula
+ * no último instante antes de passar da borda de baixo da próxima abertura.
+ * Quando a partida termina, outra começa. Com a mesma semente e os mesmos
+ * switches a sequência de partidas é sempre a mesma.
+ *
+ * Compilar: gcc -std=c99 -O2 tools/flappy_headless.c flappy_core.c -o flappy_headless
+ * Exemplo:  ./flappy_headless --frames 10000000 --sw 0x110 --seed 42
+ */
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../flappy_core.h"
+
+#define DEFAULT_FRAMES 10000000L
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Uso: %s [opções]\n"
+        "  --frames <n>    passos de física simulados (padrão %ld)\n"
+        "  --sw <valor>    switches SW0-SW9 da configuração (padrão 0)\n"
+        "  --seed <n>      semente do gerador de aberturas (padrão 1)\n",
+        prog, DEFAULT_FRAMES);
+}
+
+int main(int argc, char **argv) {
+    long frames = DEFAULT_FRAMES;
+    unsigned int switches = 0;
+    unsigned int seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) frames = atol(argv[++i]);
+        else if (strcmp(argv[i], "--sw") == 0 && i + 1 < argc) switches = (unsigned int)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = (unsigned int)strtoul(argv[++i], NULL, 0);
+        else { usage(argv[0]); return 1; }
+    }
+    if (frames <= 0) { usage(argv[0]); return 1; }
+
+    GameConfig cfg;
+    game_config_from_switches(&cfg, switches & ~0x200u); // Pausa não faz sentido aqui
+    Game game;
+    game_seed(&game, seed);
+    game_reset(&game, &cfg);
+    long games = 0;
+    long long total_score = 0;
+    int best_score = 0;
+
+    uint64_t t0 = now_ns();
+    for (long f = 0; f < frames; f++) {
+        unsigned int inputs = 0;
+        if (autopilot_jump(&game.p1, P1_X_POS, &game, &cfg)) inputs |= INPUT_JUMP_P1;
+        if (autopilot_jump(&game.p2, P2_X_POS, &game, &cfg)) inputs |= INPUT_JUMP_P2;
+        if (game_step(&game, inputs, &cfg) == GAME_OVER) {
+            int score = game.score_p1 > game.score_p2 ? game.score_p1 : game.score_p2;
+            total_score += score;
+            if (score > best_score) best_score = score;
+            games++;
+            game_reset(&game, &cfg);
+        }
+    }
+    uint64_t elapsed = now_ns() - t0;
+    int current = game.score_p1 > game.score_p2 ? game.score_p1 : game.score_p2;
+
+    printf("%ld passos, SW=0x%03X, semente %u\n", frames, switches, seed);
+    printf("tempo: %.3f s, %.2f milhões de passos/s (%.1fx tempo real)\n",
+           elapsed / 1e9, frames / (elapsed / 1e3), frames * (double)FRAME_PERIOD_NS / elapsed);
+    printf("partidas terminadas: %ld, pontuação média %.2f, melhor %d; partida em andamento: %d\n",
+           games, games ? (double)total_score / games : 0.0, best_score, current);
+    return 0;
+}
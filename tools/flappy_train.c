@@ -0,0 +1,414 @@
+/**
+ * @file flappy_train.c
+ * @brief Treina por neuroevolução a rede de flappy_brain.c que aperta KEY1,
+ * jogando com o núcleo do jogo (flappy_core.c): mesma física, espaçamento dos
+ * canos e colisões de check_collision().
+ *
+ * A cada geração, cada genoma joga --games partidas (as mesmas sementes para
+ * todos os genomas da geração); a aptidão é o total de quadros sobrevividos.
+ * Os melhores (elite) passam direto; o resto é cruzamento de pais escolhidos
+ * por torneio, com mutação. O melhor genoma até agora é gravado em --out a
+ * cada melhora, no formato que o jogo lê com --brain.
+ *
+ * As partidas de uma geração (genoma x semente) são divididas entre as threads
+ * em blocos contíguos, e uma thread sem trabalho rouba metade do que falta no
+ * bloco de outra: a duração das partidas varia de dezenas a dezenas de
+ * milhares de quadros, e uma divisão fixa deixaria threads paradas no fim.
+ * Cada partida grava o resultado na sua posição, então a evolução não depende
+ * do número de threads nem da ordem em que as partidas terminam.
+ *
+ * Compilar: gcc -std=c99 -O2 -pthread tools/flappy_train.c flappy_core.c flappy_brain.c -o flappy_train
+ * Exemplo:  ./flappy_train --sw 0x0AF --generations 100 --out cerebro.bin
+ */
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "../flappy_core.h"
+#include "../flappy_brain.h"
+
+#define DEFAULT_POPULATION  200
+#define DEFAULT_GENERATIONS 50
+#define DEFAULT_GAMES       4
+#define DEFAULT_MAX_FRAMES  18000 // 5 minutos de jogo
+#define DEFAULT_OUT         "cerebro.bin"
+#define MAX_THREADS         256
+#define ELITE_PERCENT       10
+#define TOURNAMENT_SIZE     3
+#define MUTATION_CHANCE     5     // Cada peso muda com chance 1 em 5
+#define MUTATION_STEP       FIX16(0.5)
+
+typedef struct {
+    unsigned int switches;
+    int population;
+    int generations;
+    int games;        // Partidas por genoma em cada geração
+    int max_frames;
+    int threads;
+    uint32_t seed;
+    const char *out_path;
+    int resume;
+    int scaling;
+} TrainOptions;
+
+typedef struct {
+    int score;
+    int frames;
+} GameResult;
+
+// Bloco de partidas [head, tail) de uma thread; os ladrões tiram do fim.
+typedef struct {
+    long head, tail;
+    pthread_mutex_t lock;
+} TaskRange;
+
+typedef struct {
+    const TrainOptions *opt;
+    const GameConfig *cfg;
+    const Genome *genomes;
+    uint32_t first_seed;
+    GameResult *results; // results[g * games + k]
+    TaskRange ranges[MAX_THREADS];
+    int num_threads;
+    long steals;
+    pthread_mutex_t steals_lock;
+} Generation;
+
+typedef struct {
+    Generation *gen;
+    int id;
+} Worker;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t xorshift32(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static GameResult play_game(const Genome *genome, const GameConfig *cfg, uint32_t seed, int max_frames) {
+    Game game;
+    game_seed(&game, seed);
+    game_reset(&game, cfg);
+    int f = 0;
+    while (f < max_frames && game.state == GAME_RUNNING) {
+        game_step(&game, brain_jump(genome, &game.p1, P1_X_POS, &game, cfg) ? INPUT_JUMP_P1 : 0, cfg);
+        f++;
+    }
+    return (GameResult){ game.score_p1, f };
+}
+
+// Próxima partida do próprio bloco, ou -1 se ele acabou.
+static long take_own(TaskRange *r) {
+    long task = -1;
+    pthread_mutex_lock(&r->lock);
+    if (r->head < r->tail) task = r->head++;
+    pthread_mutex_unlock(&r->lock);
+    return task;
+}
+
+/**
+ * @brief Rouba a metade final do bloco de outra thread (começando pela
+ * vizinha) e a torna o bloco de `self`.
+ * @return 1 se conseguiu roubar algo, 0 se todos os blocos estão vazios.
+ */
+static int steal(Generation *gen, int self) {
+    for (int k = 1; k < gen->num_threads; k++) {
+        TaskRange *victim = &gen->ranges[(self + k) % gen->num_threads];
+        long first = 0, last = 0;
+        pthread_mutex_lock(&victim->lock);
+        long left = victim->tail - victim->head;
+        if (left > 0) {
+            last = victim->tail;
+            first = victim->tail - (left + 1) / 2;
+            victim->tail = first;
+        }
+        pthread_mutex_unlock(&victim->lock);
+        if (last > first) {
+            TaskRange *own = &gen->ranges[self];
+            pthread_mutex_lock(&own->lock);
+            own->head = first;
+            own->tail = last;
+            pthread_mutex_unlock(&own->lock);
+            pthread_mutex_lock(&gen->steals_lock);
+            gen->steals++;
+            pthread_mutex_unlock(&gen->steals_lock);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void *train_worker(void *arg) {
+    Worker *w = arg;
+    Generation *gen = w->gen;
+    int games = gen->opt->games;
+    for (;;) {
+        long task = take_own(&gen->ranges[w->id]);
+        if (task < 0) {
+            if (!steal(gen, w->id)) break;
+            continue;
+        }
+        const Genome *genome = &gen->genomes[task / games];
+        uint32_t seed = gen->first_seed + (uint32_t)(task % games);
+        gen->results[task] = play_game(genome, gen->cfg, seed, gen->opt->max_frames);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Joga todas as partidas da geração com `threads` threads.
+ * @return Tempo gasto em ns, ou 0 se não foi possível criar as threads.
+ */
+static uint64_t evaluate(Generation *gen, int threads) {
+    pthread_t tids[MAX_THREADS];
+    Worker workers[MAX_THREADS];
+    long tasks = (long)gen->opt->population * gen->opt->games;
+    long per_thread = (tasks + threads - 1) / threads;
+    gen->num_threads = threads;
+    gen->steals = 0;
+    for (int t = 0; t < threads; t++) {
+        long head = t * per_thread < tasks ? t * per_thread : tasks;
+        long tail = head + per_thread < tasks ? head + per_thread : tasks;
+        gen->ranges[t].head = head;
+        gen->ranges[t].tail = tail;
+    }
+
+    uint64_t t0 = now_ns();
+    int started = 0;
+    for (int t = 0; t < threads; t++) {
+        workers[t] = (Worker){ gen, t };
+        if (pthread_create(&tids[t], NULL, train_worker, &workers[t]) != 0) {
+            perror("Erro ao criar thread");
+            break;
+        }
+        started++;
+    }
+    for (int t = 0; t < started; t++) pthread_join(tids[t], NULL);
+    return started == threads ? now_ns() - t0 : 0;
+}
+
+static uint32_t genome_fitness(const GameResult *results, int g, int games) {
+    uint32_t total = 0;
+    for (int k = 0; k < games; k++) total += results[g * games + k].frames;
+    return total;
+}
+
+static void random_genome(Genome *genome, uint32_t *rng) {
+    for (int i = 0; i < BRAIN_WEIGHTS; i++) {
+        genome->w[i] = (fix16)(xorshift32(rng) % (2 * FIX16_ONE + 1)) - FIX16_ONE;
+    }
+}
+
+static void mutate(Genome *genome, uint32_t *rng) {
+    for (int i = 0; i < BRAIN_WEIGHTS; i++) {
+        if (xorshift32(rng) % MUTATION_CHANCE) continue;
+        genome->w[i] += (fix16)(xorshift32(rng) % (2 * MUTATION_STEP + 1)) - MUTATION_STEP;
+    }
+}
+
+// Índice do mais apto entre TOURNAMENT_SIZE genomas sorteados.
+static int tournament(const uint32_t *fitness, int population, uint32_t *rng) {
+    int best = xorshift32(rng) % population;
+    for (int i = 1; i < TOURNAMENT_SIZE; i++) {
+        int c = xorshift32(rng) % population;
+        if (fitness[c] > fitness[best] || (fitness[c] == fitness[best] && c < best)) best = c;
+    }
+    return best;
+}
+
+/**
+ * @brief Monta a próxima geração em `next`: a elite (ordenada por aptidão e,
+ * no empate, pelo índice) seguida de filhos de torneios com cruzamento
+ * uniforme e mutação.
+ */
+static void breed(const Genome *cur, const uint32_t *fitness, Genome *next, int population, uint32_t *rng) {
+    int elite = population * ELITE_PERCENT / 100;
+    if (elite < 1) elite = 1;
+    char *taken = calloc(population, 1);
+    if (!taken) { perror("Erro ao alocar a seleção"); exit(1); }
+    for (int e = 0; e < elite; e++) {
+        int best = -1;
+        for (int g = 0; g < population; g++) {
+            if (!taken[g] && (best < 0 || fitness[g] > fitness[best])) best = g;
+        }
+        taken[best] = 1;
+        next[e] = cur[best];
+    }
+    free(taken);
+    for (int g = elite; g < population; g++) {
+        const Genome *a = &cur[tournament(fitness, population, rng)];
+        const Genome *b = &cur[tournament(fitness, population, rng)];
+        uint32_t bits = 0;
+        for (int i = 0; i < BRAIN_WEIGHTS; i++) {
+            if (i % 32 == 0) bits = xorshift32(rng);
+            next[g].w[i] = (bits >> (i % 32)) & 1 ? a->w[i] : b->w[i];
+        }
+        mutate(&next[g], rng);
+    }
+}
+
+/**
+ * @brief Repete a avaliação da última geração com 1, 2, 4, ... N threads e
+ * confere que os resultados são os mesmos.
+ * @return Número de execuções com resultado diferente, ou -1 em caso de falha.
+ */
+static int run_scaling(Generation *gen, const GameResult *reference) {
+    long tasks = (long)gen->opt->population * gen->opt->games;
+    int mismatches = 0;
+    double base_rate = 0;
+    printf("\n%7s %10s %12s %8s %8s\n", "threads", "tempo(s)", "partidas/s", "escala", "roubos");
+    for (int threads = 1;; threads = threads * 2 > gen->opt->threads ? gen->opt->threads : threads * 2) {
+        uint64_t ns = evaluate(gen, threads);
+        if (ns == 0) return -1;
+        double rate = tasks / (ns / 1e9);
+        if (threads == 1) base_rate = rate;
+        if (memcmp(gen->results, reference, tasks * sizeof(GameResult)) != 0) mismatches++;
+        printf("%7d %10.3f %12.0f %7.2fx %8ld\n", threads, ns / 1e9, rate, rate / base_rate, gen->steals);
+        if (threads == gen->opt->threads) break;
+    }
+    return mismatches;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Uso: %s [opções]\n"
+        "  --sw <valor>          configuração SW0-SW7 do treino (padrão 0x000)\n"
+        "  --population <n>      genomas por geração (padrão %d)\n"
+        "  --generations <n>     gerações (padrão %d)\n"
+        "  --games <n>           partidas por genoma em cada geração (padrão %d)\n"
+        "  --max-frames <n>      limite de quadros por partida (padrão %d)\n"
+        "  --threads <n>         threads (padrão: núcleos disponíveis)\n"
+        "  --seed <n>            semente do treino (padrão 1)\n"
+        "  --out <arquivo>       onde gravar o melhor genoma (padrão %s)\n"
+        "  --resume              começa a partir do genoma gravado em --out\n"
+        "  --scaling             no fim, mede a escala com 1, 2, 4, ... threads\n",
+        prog, DEFAULT_POPULATION, DEFAULT_GENERATIONS, DEFAULT_GAMES, DEFAULT_MAX_FRAMES, DEFAULT_OUT);
+}
+
+int main(int argc, char **argv) {
+    TrainOptions opt = { 0x000, DEFAULT_POPULATION, DEFAULT_GENERATIONS, DEFAULT_GAMES,
+                         DEFAULT_MAX_FRAMES, 0, 1, DEFAULT_OUT, 0, 0 };
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--sw") == 0 && i + 1 < argc) opt.switches = (unsigned int)strtoul(argv[++i], NULL, 0) & 0xFF;
+        else if (strcmp(argv[i], "--population") == 0 && i + 1 < argc) opt.population = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--generations") == 0 && i + 1 < argc) opt.generations = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) opt.games = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max-frames") == 0 && i + 1 < argc) opt.max_frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) opt.threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) opt.seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) opt.out_path = argv[++i];
+        else if (strcmp(argv[i], "--resume") == 0) opt.resume = 1;
+        else if (strcmp(argv[i], "--scaling") == 0) opt.scaling = 1;
+        else { usage(argv[0]); return 1; }
+    }
+    if (opt.threads <= 0) opt.threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (opt.threads > MAX_THREADS) opt.threads = MAX_THREADS;
+    if (opt.population < 2 || opt.generations <= 0 || opt.games <= 0 || opt.max_frames <= 0 || opt.threads <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    GameConfig cfg;
+    game_config_from_switches(&cfg, opt.switches);
+    long tasks = (long)opt.population * opt.games;
+    Genome *genomes = malloc(opt.population * sizeof(Genome));
+    Genome *next = malloc(opt.population * sizeof(Genome));
+    uint32_t *fitness = malloc(opt.population * sizeof(uint32_t));
+    GameResult *results = malloc(tasks * sizeof(GameResult));
+    GameResult *reference = malloc(tasks * sizeof(GameResult));
+    if (!genomes || !next || !fitness || !results || !reference) { perror("Erro ao alocar a população"); return 1; }
+
+    uint32_t rng = opt.seed ? opt.seed : 1;
+    for (int g = 0; g < opt.population; g++) random_genome(&genomes[g], &rng);
+    uint32_t best_fitness = 0;
+    if (opt.resume) {
+        // O genoma gravado e mutações dele substituem metade da população inicial.
+        if (genome_load(&genomes[0], opt.out_path, NULL, NULL) != 0) return 1;
+        for (int g = 1; g < opt.population / 2; g++) {
+            genomes[g] = genomes[0];
+            mutate(&genomes[g], &rng);
+        }
+    }
+
+    Generation gen = { 0 };
+    gen.opt = &opt;
+    gen.cfg = &cfg;
+    gen.results = results;
+    pthread_mutex_init(&gen.steals_lock, NULL);
+    for (int t = 0; t < MAX_THREADS; t++) pthread_mutex_init(&gen.ranges[t].lock, NULL);
+
+    printf("SW 0x%03X, %d genomas x %d partidas, até %d quadros, %d thread(s), %d pesos por genoma\n",
+           opt.switches, opt.population, opt.games, opt.max_frames, opt.threads, BRAIN_WEIGHTS);
+    printf("%7s %12s %10s %12s %12s %14s %8s\n",
+           "geração", "melhor(s)", "pontos", "média(s)", "partidas/s", "quadros/s", "roubos");
+
+    uint64_t total_ns = 0, total_frames = 0;
+    for (int generation = 0; generation < opt.generations; generation++) {
+        gen.genomes = genomes;
+        gen.first_seed = opt.seed + (uint32_t)generation * opt.games;
+        uint64_t ns = evaluate(&gen, opt.threads);
+        if (ns == 0) return 1;
+
+        int best = 0;
+        double mean = 0;
+        uint64_t frames = 0;
+        for (int g = 0; g < opt.population; g++) {
+            fitness[g] = genome_fitness(results, g, opt.games);
+            if (fitness[g] > fitness[best]) best = g;
+            mean += fitness[g];
+        }
+        int best_score = 0;
+        for (int k = 0; k < opt.games; k++) best_score += results[best * opt.games + k].score;
+        for (long t = 0; t < tasks; t++) frames += results[t].frames;
+        total_ns += ns;
+        total_frames += frames;
+
+        double per_game = (double)FRAME_PERIOD_US / 1e6 / opt.games;
+        printf("%7d %12.1f %10.1f %12.1f %12.0f %14.0f %8ld\n", generation, fitness[best] * per_game,
+               (double)best_score / opt.games, mean / opt.population * per_game, tasks / (ns / 1e9),
+               frames / (ns / 1e9), gen.steals);
+        fflush(stdout);
+
+        if (fitness[best] > best_fitness) {
+            best_fitness = fitness[best];
+            if (genome_save(&genomes[best], opt.out_path, opt.switches, best_fitness) != 0) return 1;
+        }
+        if (generation + 1 < opt.generations) {
+            breed(genomes, fitness, next, opt.population, &rng);
+            Genome *tmp = genomes;
+            genomes = next;
+            next = tmp;
+        }
+    }
+    printf("Total: %.0f partidas/s, %.0f quadros/s; melhor genoma (%.1f s por partida) em %s\n",
+           (double)tasks * opt.generations / (total_ns / 1e9), total_frames / (total_ns / 1e9),
+           best_fitness * (double)FRAME_PERIOD_US / 1e6 / opt.games, opt.out_path);
+
+    int mismatches = 0;
+    if (opt.scaling) {
+        memcpy(reference, results, tasks * sizeof(GameResult));
+        mismatches = run_scaling(&gen, reference);
+        if (mismatches < 0) return 1;
+        if (mismatches) fprintf(stderr, "Resultados diferentes entre execuções com número de threads diferente\n");
+    }
+
+    free(genomes);
+    free(next);
+    free(fitness);
+    free(results);
+    free(reference);
+    return mismatches ? 1 : 0;
+}